@@ -1,18 +1,32 @@
 # pragma once
 #include <string>
+#include <string_view>
+#include <atomic>
+#include <optional>
+#include <type_traits>
 #include "Vector.hpp"
+#include "Trace.hpp"
+#ifdef CHIMPSTL_STATS
+#include <sstream>
+#endif
 
 typedef std::string Key;
 
-template <typename T>
+// Keyed by lowercase strings. Integer keys select the radix-trie
+// specialization in ChimpMapRadix.hpp: ChimpMap<T, uint64_t>, or
+// ChimpMap<T, RadixKey<uint64_t, 16>> for 16-bit chunks.
+template <typename T, typename K = Key>
 class ChimpMap {
+    static_assert(std::is_same_v<K, Key>, "ChimpMap keys are std::string or an integer type");
+
 private:
     struct Node {
         Node* children[26];
         bool isEndOfWord;
-        T value;
+        int slot;                       // index of the value in the slab, -1 if none
+        std::atomic<int> refCount;      // number of maps / parents sharing this node
     
-        Node() : isEndOfWord(false) {
+        Node() : isEndOfWord(false), slot(-1), refCount(1) {
             for(int i = 0; i < 26; ++i) {
                 children[i] = nullptr;
             }
@@ -31,34 +45,154 @@ private:
         }
     };
 
+    // VALUE SLAB
+    // Values of terminal nodes live out of line, densely packed in fixed-size
+    // chunks, so interior nodes carry no T and a T is only constructed on insert.
+    // The chunks hang off a radix directory (FANOUT entries per level, slot
+    // order left to right) and both are shared with snapshots copy-on-write like
+    // nodes: a write clones the O(log N) directory path to its chunk and that
+    // chunk's CHUNK values, never the whole table. Free slots form a list
+    // threaded through the chunks, so the Slab header itself is a plain value.
+    static const int CHUNK = 8;
+    static const int FANOUT = 64;
+    static const int FANOUT_BITS = 6;
+
+    struct Block {
+        std::atomic<int> refCount;      // number of slabs / directories sharing this block
+        Block() : refCount(1) {}
+    };
+
+    struct Chunk : Block {
+        alignas(T) unsigned char storage[CHUNK * sizeof(T)];
+        bool live[CHUNK];
+        int nextFree[CHUNK];            // free-list link of a dead slot
+
+        Chunk() {
+            for(int i = 0; i < CHUNK; i++) {
+                live[i] = false;
+                nextFree[i] = -1;
+            }
+        }
+
+        T* at(int i) { return reinterpret_cast<T*>(storage) + i; }
+
+        ~Chunk() {
+            for(int i = 0; i < CHUNK; i++) {
+                if(live[i]) at(i)->~T();
+            }
+        }
+    };
+
+    struct Directory : Block {
+        Block* entries[FANOUT];         // Directory one level down, Chunk on the bottom level
+
+        Directory() {
+            for(int i = 0; i < FANOUT; i++) {
+                entries[i] = nullptr;
+            }
+        }
+    };
+
+    struct Slab {
+        Block* top;                     // root of the directory, nullptr while empty
+        int height;                     // directory levels above the chunks
+        int used;                       // slots handed out so far
+        int freeHead;                   // first slot released by erase, -1 if none
+
+        Slab() : top(nullptr), height(0), used(0), freeHead(-1) {}
+
+        static int digit(int slot, int level) { return (slot / CHUNK >> (FANOUT_BITS * (level - 1))) & (FANOUT - 1); }
+
+        T* at(int slot) const {
+            Block* block = top;
+            for(int level = height; level > 0; level--) {
+                block = static_cast<Directory*>(block)->entries[digit(slot, level)];
+            }
+            return static_cast<Chunk*>(block)->at(slot % CHUNK);
+        }
+    };
+
     Node* root;
+    Slab values;
     int keyCount;
+
+    Chunk* ownChunk(int slot);
+    Directory* ownDirectory(Block*& entry, int level);
+    T& valueRef(int slot) { return *ownChunk(slot)->at(slot % CHUNK); }
+    template <class... Args>
+    int construct(Args&&... args);
+    void destroy(int slot);
+    static void release(Block* block, int level);
+    static void release(Slab& slab) {
+        release(slab.top, slab.height);
+        slab = Slab();
+    }
+    template <class Function>
+    static void forEachValue(Block* block, int level, Function& fn);
+
+#ifdef CHIMPSTL_TRACE
+    mutable TraceCounters traceCounters;
+    void trace(TraceEvent event, size_t amount) const { recordTrace(traceCounters, event, this, amount); }
+#else
+    void trace(TraceEvent, size_t) const {}
+#endif
+
+    Node* createNode() {
+        trace(TraceEvent::NodeCreate, sizeof(Node));
+        return new Node();
+    }
+
+    void freeNode(Node* node) {
+        trace(TraceEvent::NodeFree, sizeof(Node));
+        delete node;
+    }
+
+    Directory* createDirectory() {
+        trace(TraceEvent::Allocate, sizeof(Directory));
+        return new Directory();
+    }
+
+    Chunk* createChunk() {
+        trace(TraceEvent::Allocate, sizeof(Chunk));
+        return new Chunk();
+    }
+
+    // COPY-ON-WRITE HELPERS
+    // Nodes are shared between a map and its copies/snapshots. A node whose
+    // refCount is above 1 is never modified in place: it is cloned first.
+    Node* copyNode(Node* node);
+    Node* own(Node*& slot);
+    Node* find(std::string_view key) const;
+    Node* findOrCreate(std::string_view key);
+public:
+    struct FuzzyMatch {
+        Key key;
+        int distance;
+        const T* value;                 // into the map, valid until it is next modified
+    };
+private:
+    void fuzzySearch(Node* node, Vector<int>& rows, std::string_view query, Key& prefix,
+                     int maxDistance, Vector<FuzzyMatch>& matches) const;
+    void mergeNode(Node* into, Node* from, ChimpMap& other);
+    void adopt(Node*& slot, ChimpMap& other);
 public:
     // CONSTRUCTORS
 
     // 1. Default Constructor
     ChimpMap() { 
-        root = new Node(); 
+        root = createNode(); 
         keyCount = 0;
     }
 
-    // 2. Copy Constructor
-    ChimpMap(ChimpMap<T>& other) {  
-        root = copyNode(other.node);             
+    // 2. Copy Constructor (O(1), shares every node with other)
+    ChimpMap(const ChimpMap<T, K>& other) {  
+        root = other.root;
+        values = other.values;
+        if(root) root->refCount++;
+        if(values.top) values.top->refCount++;
         keyCount = other.keyCount;
     }
 
-    Node* copyNode(Node* root) {
-        if(!root) return nullptr;
-        Node* newNode = new Node();
-        newNode->isEndOfWord = root->isEndOfWord;
-        newNode->value = root->value;
-        for(int i = 0; i < 26; i++) {
-            newNode->children[i] = copyNode(root->children[i]);
-        }
-        return newNode;
-    }
-
     // 3. Brace-enclosed initialized list Constructor
     ChimpMap(std::initializer_list<std::pair<const Key, T>> init) : ChimpMap() {
         for(const auto& [key, value] : init) {
@@ -70,9 +204,11 @@ public:
     // 4. Move Constructor
     ChimpMap(ChimpMap&& other) noexcept {
         root = other.root;
+        values = other.values;
         keyCount = other.keyCount;
 
         other.root = nullptr;
+        other.values = Slab();
         other.keyCount = 0;
     }
 
@@ -87,26 +223,32 @@ public:
 
         Vector<std::tuple<Node*, int, Key>> ahead;
         Vector<std::tuple<Node*, int, Key>> back;
-        value_type current;
+        std::optional<value_type> current;      // empty past either end; T needs no default
+        const Slab* values;
+        Node* deferred = nullptr;               // end(): root of the walk filling back, run on the first --
 
 
-        Iterator(Node* root, int value = 0) {
+        Iterator(Node* root, const Slab* values, int value = 0) : values(values) {
+            if(value != 0) {
+                deferred = root;
+                return;
+            }
             if(root) push(root, "");
-            if(value == 0) ++(*this);
-            else pushAll();
+            ++(*this);
         }
 
-        reference operator*() { return current; }
-        pointer operator->() { return this; }
+        reference operator*() { return *current; }
+        pointer operator->() { return &*current; }
 
         Iterator& operator++() { 
+            if(deferred) return *this;
             while(!ahead.empty()) {
                 auto [node, i, prefix] = ahead.back();
                 ahead.pop_back();
 
                 if(node->isEndOfWord) {
                     back.push_back({node, i, prefix});
-                    current = {prefix, node->value};
+                    current.emplace(prefix, *values->at(node->slot));
                     push(node, prefix);
                     return *this;
                 }
@@ -114,31 +256,43 @@ public:
                 push(node, prefix);
             }
             
-            current = {};
+            current.reset();
             return *this;
         }
 
         Iterator& operator--() {
+            if(deferred) {
+                push(deferred, "");
+                deferred = nullptr;
+                pushAll();
+            }
             if(!back.empty()) {
-                if(current != std::pair<Key, T>{}) {
+                if(current) {
                     auto next = back.back();
                     back.pop_back();
                     ahead.push_back(next);
                 }
 
                 auto [node, i, prefix] = back.back();
-                current = {prefix, node->value};
+                current.emplace(prefix, *values->at(node->slot));
                 push(node, prefix);
                 return *this;
             }
 
-            current = {};
+            current.reset();
             return *this;
         }
 
         Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
         Iterator operator--(int) { Iterator tmp = *this; --(*this); return tmp; }
 
+        // Positions compare by key; every iterator past the end is equal.
+        friend bool operator==(const Iterator& a, const Iterator& b) {
+            if(!a.current || !b.current) return !a.current && !b.current;
+            return a.current->first == b.current->first;
+        }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return !(a == b); }
+
     private:
         void push(Node* node, std::string prefix) {
             for(int i = 25; i >= 0; i--) {
@@ -155,14 +309,12 @@ public:
 
                 if(node->isEndOfWord) {
                     back.push_back({node, i, prefix});
-                    current = {prefix, node->value};
-                    push(node, prefix);
                 }
 
                 push(node, prefix);
             }
 
-            current = {};
+            current.reset();
             return *this;
         }
     };
@@ -177,26 +329,32 @@ public:
 
         Vector<std::tuple<Node*, int, Key>> ahead;
         Vector<std::tuple<Node*, int, Key>> back;
-        value_type current;
+        std::optional<value_type> current;      // empty past either end; T needs no default
+        const Slab* values;
+        Node* deferred = nullptr;               // end(): root of the walk filling back, run on the first --
 
 
-        ConstIterator(Node* root, int value = 0) {
+        ConstIterator(Node* root, const Slab* values, int value = 0) : values(values) {
+            if(value != 0) {
+                deferred = root;
+                return;
+            }
             if(root) push(root, "");
-            if(value == 0) ++(*this);
-            else pushAll();
+            ++(*this);
         }
 
-        reference operator*() { return current; }
-        pointer operator->() { return this; }
+        reference operator*() { return *current; }
+        pointer operator->() { return &*current; }
 
         ConstIterator& operator++() { 
+            if(deferred) return *this;
             while(!ahead.empty()) {
                 auto [node, i, prefix] = ahead.back();
                 ahead.pop_back();
 
                 if(node->isEndOfWord) {
                     back.push_back({node, i, prefix});
-                    current = {prefix, node->value};
+                    current.emplace(prefix, *values->at(node->slot));
                     push(node, prefix);
                     return *this;
                 }
@@ -204,31 +362,43 @@ public:
                 push(node, prefix);
             }
             
-            current = {};
+            current.reset();
             return *this;
         }
 
         ConstIterator& operator--() {
+            if(deferred) {
+                push(deferred, "");
+                deferred = nullptr;
+                pushAll();
+            }
             if(!back.empty()) {
-                if(current != std::pair<Key, T>{}) {
+                if(current) {
                     auto next = back.back();
                     back.pop_back();
                     ahead.push_back(next);
                 }
 
                 auto [node, i, prefix] = back.back();
-                current = {prefix, node->value};
+                current.emplace(prefix, *values->at(node->slot));
                 push(node, prefix);
                 return *this;
             }
 
-            current = {};
+            current.reset();
             return *this;
         }
 
         ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
         ConstIterator operator--(int) { ConstIterator tmp = *this; --(*this); return tmp; }
 
+        // Positions compare by key; every iterator past the end is equal.
+        friend bool operator==(const ConstIterator& a, const ConstIterator& b) {
+            if(!a.current || !b.current) return !a.current && !b.current;
+            return a.current->first == b.current->first;
+        }
+        friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return !(a == b); }
+
     private:
         void push(Node* node, std::string prefix) {
             for(int i = 25; i >= 0; i--) {
@@ -245,128 +415,532 @@ public:
 
                 if(node->isEndOfWord) {
                     back.push_back({node, i, prefix});
-                    current = {prefix, node->value};
-                    push(node, prefix);
                 }
 
                 push(node, prefix);
             }
 
-            current = {};
+            current.reset();
             return *this;
         }
     };
 
-    Iterator begin()  { return Iterator(root); }                         
-    Iterator end()    { return Iterator(root, 1); }
-    ConstIterator begin()  const { return ConstIterator(root); }             
-    ConstIterator end()    const { return ConstIterator(root, 1); }
-    ConstIterator cbegin() const { return ConstIterator(root); }         
-    ConstIterator cend()   const { return ConstIterator(root, 1 ); }
+    Iterator begin()  { return Iterator(root, &values); }                         
+    Iterator end()    { return Iterator(root, &values, 1); }
+    ConstIterator begin()  const { return ConstIterator(root, &values); }             
+    ConstIterator end()    const { return ConstIterator(root, &values, 1); }
+    ConstIterator cbegin() const { return ConstIterator(root, &values); }         
+    ConstIterator cend()   const { return ConstIterator(root, &values, 1 ); }
 
 
     // MEMBER FUNCTIONS
     size_t length() const { return keyCount;      }
     bool empty()    const { return keyCount == 0; }
 
-    void insert(const Key& key, const T& value);
-    T& at(const Key& key);
-    bool count(const Key& key);
-    void erase(const Key& key);
+    // Point-in-time view of the map. O(1): the snapshot shares all nodes and
+    // values; later writes to either map copy only the trie path they touch,
+    // plus one slab chunk and its directory path.
+    ChimpMap<T, K> snapshot() const { return ChimpMap<T, K>(*this); }
+
+    // Insert-or-lookup in a single walk from the root. Each returns a pointer
+    // to the key's value, valid until the map is next modified, and whether
+    // the key was added.
+    std::pair<T*, bool> insert(std::string_view key, const T& value);
+
+    // Constructs the value in place from args only when key is absent.
+    template <class... Args>
+    std::pair<T*, bool> try_emplace(std::string_view key, Args&&... args);
+
+    // Assigns value to an existing key, or constructs it in place from value.
+    template <class M>
+    std::pair<T*, bool> insert_or_assign(std::string_view key, M&& value);
+
+    // Read-modify-write: calls fn(T&) on key's value, constructing T() first
+    // when key is absent, e.g. counts.update(word, [](int& n) { n++; }).
+    template <class Function>
+    std::pair<T*, bool> update(std::string_view key, Function fn);
+
+    T& at(std::string_view key);
+    bool count(std::string_view key) const;
+    void erase(std::string_view key);
     void clear() { 
         clear(root); 
-        root = new Node();
+        release(values);
+        root = createNode();
         keyCount = 0;
     }
 
+#ifdef CHIMPSTL_TRACE
+    const TraceCounters& trace_counters() const { return traceCounters; }
+#endif
+
+    // Visits every value in slab order, without walking the trie.
+    template <class Function>
+    void for_each_value(Function fn) const;
+
+    // Keys within max_distance edits (Levenshtein) of query, in key order. The
+    // walk carries one DP row per node and skips every subtree whose row minimum
+    // already exceeds the bound, so cost follows the explored part of the trie.
+    Vector<FuzzyMatch> fuzzy_find(std::string_view query, int max_distance) const;
+
+    // Moves every key of other into this map, keeping this map's value for keys
+    // present in both. Subtrees missing here are relinked rather than rebuilt;
+    // only their values move into this map's slab. other is left empty.
+    void merge(ChimpMap&& other);
+
     template <class... Args>
-    void emplace(const Key& key, Args&&... args);
+    void emplace(std::string_view key, Args&&... args);
+
+#ifdef CHIMPSTL_STATS
+    // STATISTICS (compiled only with -DCHIMPSTL_STATS)
+    // Nodes shared with snapshots are counted in every map that reaches them.
+    struct Stats {
+        size_t keys = 0;
+        size_t nodes = 0;
+        size_t bytes = 0;                 // nodes, value slab and the map itself
+        size_t fillHistogram[27] = {};    // nodes by number of non-null children
+        Vector<size_t> depthHistogram;    // nodes by depth, root at depth 0
+        double averageKeyLength = 0;
+
+        std::string toText() const;
+        std::string toJSON() const;
+    };
+
+    Stats stats() const;
+#endif
 
     // OVERLOADED OPERATORS
-    T& operator[](const Key& key);
-    const T& operator[](const Key& key) const;
+    T& operator[](std::string_view key);
+    const T& operator[](std::string_view key) const;
 
-    ChimpMap<T>& operator=(const ChimpMap<T>& other);  /* Copy Assignment Operator */
-    ChimpMap<T>& operator=(std::initializer_list<std::pair<const Key, T>> init);
+    ChimpMap<T, K>& operator=(const ChimpMap<T, K>& other);  /* Copy Assignment Operator */
+    ChimpMap<T, K>& operator=(std::initializer_list<std::pair<const Key, T>> init);
 
-    ChimpMap<T>& operator=(ChimpMap&& other) noexcept; /* Move Assignment Operator */
+    ChimpMap<T, K>& operator=(ChimpMap&& other) noexcept; /* Move Assignment Operator */
 
     
-    ~ChimpMap() { clear(root); }
-    void clear(Node* node) {
-        if(!node) return;
+    ~ChimpMap() { 
+        clear(root); 
+        release(values);
+    }
+    void clear(Node* node) {                 // drops one reference to node
+        if(!node || --node->refCount > 0) return;
         for(int i = 0; i < 26; i++) clear(node->children[i]);
-        delete node;
+        freeNode(node);
     }
 };    
 
-template <typename T>
-void ChimpMap<T>::insert(const Key& key, const T& value) {
-    Node* node = root;
-    for(char ch : key) {
-        int index = ch - 'a';
-        if(!node->children[index]) {
-            node->children[index] = new Node();
+template <typename T, typename K>
+typename ChimpMap<T, K>::Node* ChimpMap<T, K>::copyNode(Node* node) {
+    Node* newNode = createNode();
+    newNode->isEndOfWord = node->isEndOfWord;
+    newNode->slot = node->slot;
+    for(int i = 0; i < 26; i++) {
+        newNode->children[i] = node->children[i];
+        if(newNode->children[i]) newNode->children[i]->refCount++;
+    }
+    return newNode;
+}
+
+// Unshares the directory held in entry, cloning it if a snapshot still sees it.
+template <typename T, typename K>
+typename ChimpMap<T, K>::Directory* ChimpMap<T, K>::ownDirectory(Block*& entry, int level) {
+    if(!entry) {
+        entry = createDirectory();
+    }
+    else if(entry->refCount > 1) {
+        Directory* directory = static_cast<Directory*>(entry);
+        Directory* newDirectory = createDirectory();
+        for(int i = 0; i < FANOUT; i++) {
+            newDirectory->entries[i] = directory->entries[i];
+            if(newDirectory->entries[i]) newDirectory->entries[i]->refCount++;
         }
-        node = node->children[index];
+        release(entry, level);
+        entry = newDirectory;
     }
-    if(node->isEndOfWord) return;
+    return static_cast<Directory*>(entry);
+}
 
-    node->isEndOfWord = true;
-    node->value = value;
-    keyCount++;
+// Unshares the path from the directory root to slot's chunk, creating
+// missing directories and the chunk itself for a fresh slot.
+template <typename T, typename K>
+typename ChimpMap<T, K>::Chunk* ChimpMap<T, K>::ownChunk(int slot) {
+    Block** entry = &values.top;
+    for(int level = values.height; level > 0; level--) {
+        entry = &ownDirectory(*entry, level)->entries[Slab::digit(slot, level)];
+    }
+
+    if(!*entry) {
+        trace(TraceEvent::Allocate, sizeof(Chunk));
+        *entry = new Chunk();
+    }
+    else if((*entry)->refCount > 1) {
+        Chunk* chunk = static_cast<Chunk*>(*entry);
+        Chunk* newChunk = new Chunk();
+        trace(TraceEvent::Allocate, sizeof(Chunk));
+        int copied = 0;
+        for(int i = 0; i < CHUNK; i++) {
+            if(chunk->live[i]) {
+                new (newChunk->at(i)) T(*chunk->at(i));
+                newChunk->live[i] = true;
+                copied++;
+            }
+            newChunk->nextFree[i] = chunk->nextFree[i];
+        }
+        trace(TraceEvent::Copy, copied);
+
+        release(*entry, 0);
+        *entry = newChunk;
+    }
+    return static_cast<Chunk*>(*entry);
 }
 
-template <typename T>
-T& ChimpMap<T>::at(const Key& key) {
-    Node* node = root;
-    for(char ch : key) {
-        int index = ch - 'a';
-        if(!node->children[index]) {
-            node->children[index] = new Node();
+template <typename T, typename K>
+template <class... Args>
+int ChimpMap<T, K>::construct(Args&&... args) {
+    int slot;
+    Chunk* chunk;
+    if(values.freeHead >= 0) {
+        slot = values.freeHead;
+        chunk = ownChunk(slot);
+        values.freeHead = chunk->nextFree[slot % CHUNK];
+    }
+    else {
+        slot = values.used++;
+        if(slot == 0 || slot / CHUNK >> (FANOUT_BITS * values.height) > 0) {   // directory full: add a level on top
+            Directory* top = createDirectory();
+            top->entries[0] = values.top;
+            values.top = top;
+            values.height++;
         }
-        node = node->children[index];
+        chunk = ownChunk(slot);
     }
 
-    if(node->isEndOfWord == false) {
-        std::cerr << "Key " << key << " not available." << std::endl;
-        std::exit(EXIT_FAILURE);
+    new (chunk->at(slot % CHUNK)) T(std::forward<Args>(args)...);
+    chunk->live[slot % CHUNK] = true;
+    return slot;
+}
+
+template <typename T, typename K>
+void ChimpMap<T, K>::destroy(int slot) {
+    Chunk* chunk = ownChunk(slot);
+    chunk->at(slot % CHUNK)->~T();
+    chunk->live[slot % CHUNK] = false;
+    chunk->nextFree[slot % CHUNK] = values.freeHead;
+    values.freeHead = slot;
+}
+
+// Drops one reference to a directory (level > 0) or chunk (level 0).
+template <typename T, typename K>
+void ChimpMap<T, K>::release(Block* block, int level) {
+    if(!block || --block->refCount > 0) return;
+    if(level == 0) {
+        delete static_cast<Chunk*>(block);
+        return;
     }
 
-    return node->value;
+    Directory* directory = static_cast<Directory*>(block);
+    for(int i = 0; i < FANOUT; i++) {
+        release(directory->entries[i], level - 1);
+    }
+    delete directory;
 }
 
-template <typename T>
-bool ChimpMap<T>::count(const Key& key) {
+template <typename T, typename K>
+template <class Function>
+void ChimpMap<T, K>::forEachValue(Block* block, int level, Function& fn) {
+    if(!block) return;
+    if(level == 0) {
+        Chunk* chunk = static_cast<Chunk*>(block);
+        for(int i = 0; i < CHUNK; i++) {
+            if(chunk->live[i]) fn(*chunk->at(i));
+        }
+        return;
+    }
+
+    Directory* directory = static_cast<Directory*>(block);
+    for(int i = 0; i < FANOUT; i++) {
+        forEachValue(directory->entries[i], level - 1, fn);
+    }
+}
+
+template <typename T, typename K>
+template <class Function>
+void ChimpMap<T, K>::for_each_value(Function fn) const {
+    forEachValue(values.top, values.height, fn);
+}
+
+template <typename T, typename K>
+Vector<typename ChimpMap<T, K>::FuzzyMatch> ChimpMap<T, K>::fuzzy_find(std::string_view query, int max_distance) const {
+    Vector<FuzzyMatch> matches;
+    if(!root) return matches;
+
+    Vector<int> rows((int)query.size() + 1);           // one DP row per depth, grown as the walk descends
+    for(int i = 0; i <= (int)query.size(); i++) {
+        rows[i] = i;
+    }
+
+    Key prefix;
+    fuzzySearch(root, rows, query, prefix, max_distance, matches);
+    return matches;
+}
+
+template <typename T, typename K>
+void ChimpMap<T, K>::fuzzySearch(Node* node, Vector<int>& rows, std::string_view query, Key& prefix,
+                              int maxDistance, Vector<FuzzyMatch>& matches) const {
+    int n = query.size();
+    size_t depth = prefix.size();
+    if(node->isEndOfWord && rows.data()[depth * (n + 1) + n] <= maxDistance) {
+        matches.push_back({prefix, rows.data()[depth * (n + 1) + n], values.at(node->slot)});
+    }
+    if(rows.length() < (depth + 2) * (n + 1)) rows.resize((int)((depth + 2) * (n + 1)));
+
+    for(int c = 0; c < 26; c++) {
+        if(!node->children[c]) continue;
+
+        const int* row = rows.data() + depth * (n + 1);      // re-read: deeper calls may grow rows
+        int* next = rows.data() + (depth + 1) * (n + 1);
+        next[0] = row[0] + 1;
+        int best = next[0];
+        for(int i = 1; i <= n; i++) {
+            int substitute = row[i-1] + (query[i-1] != 'a' + c);
+            next[i] = std::min({next[i-1] + 1, row[i] + 1, substitute});
+            best = std::min(best, next[i]);
+        }
+        if(best > maxDistance) continue;
+
+        prefix.push_back('a' + c);
+        fuzzySearch(node->children[c], rows, query, prefix, maxDistance, matches);
+        prefix.pop_back();
+    }
+}
+
+template <typename T, typename K>
+void ChimpMap<T, K>::merge(ChimpMap&& other) {
+    if(this == &other || !other.root) return;
+    mergeNode(own(root), other.own(other.root), other);
+    other.clear();
+}
+
+template <typename T, typename K>
+void ChimpMap<T, K>::mergeNode(Node* into, Node* from, ChimpMap& other) {
+    if(from->isEndOfWord && !into->isEndOfWord) {
+        into->slot = construct(std::move(other.valueRef(from->slot)));
+        trace(TraceEvent::Move, 1);
+        into->isEndOfWord = true;
+        keyCount++;
+    }
+
+    for(int i = 0; i < 26; i++) {
+        if(!from->children[i]) continue;
+
+        if(!into->children[i]) {
+            into->children[i] = from->children[i];
+            from->children[i] = nullptr;
+            adopt(into->children[i], other);
+        }
+        else {
+            mergeNode(own(into->children[i]), other.own(from->children[i]), other);
+        }
+    }
+}
+
+template <typename T, typename K>
+void ChimpMap<T, K>::adopt(Node*& slot, ChimpMap& other) {
+    Node* node = own(slot);             // clones nodes other's snapshots still see
+    if(node->isEndOfWord) {
+        node->slot = construct(std::move(other.valueRef(node->slot)));
+        trace(TraceEvent::Move, 1);
+        keyCount++;
+    }
+
+    for(int i = 0; i < 26; i++) {
+        if(node->children[i]) adopt(node->children[i], other);
+    }
+}
+
+template <typename T, typename K>
+typename ChimpMap<T, K>::Node* ChimpMap<T, K>::own(Node*& slot) {
+    if(slot->refCount > 1) {
+        Node* newNode = copyNode(slot);
+        clear(slot);
+        slot = newNode;
+    }
+    return slot;
+}
+
+template <typename T, typename K>
+typename ChimpMap<T, K>::Node* ChimpMap<T, K>::find(std::string_view key) const {
     Node* node = root;
+    for(char ch : key) {
+        if(!node) return nullptr;
+        node = node->children[ch - 'a'];
+    }
+    return node;
+}
+
+template <typename T, typename K>
+typename ChimpMap<T, K>::Node* ChimpMap<T, K>::findOrCreate(std::string_view key) {
+    Node* node = own(root);
     for(char ch : key) {
         int index = ch - 'a';
         if(!node->children[index]) {
-            node->children[index] = new Node();
+            node->children[index] = createNode();
+        }
+        node = own(node->children[index]);
+    }
+    return node;
+}
+
+#ifdef CHIMPSTL_STATS
+template <typename T, typename K>
+typename ChimpMap<T, K>::Stats ChimpMap<T, K>::stats() const {
+    Stats result;
+    result.keys = keyCount;
+    result.bytes = sizeof(ChimpMap<T, K>);
+    if(!root) return result;
+
+    size_t keyLengthSum = 0;
+    Vector<std::pair<Node*, size_t>> stack;
+    stack.push_back({root, 0});
+
+    while(!stack.empty()) {
+        auto [node, depth] = stack.back();
+        stack.pop_back();
+
+        int filled = 0;
+        for(int i = 0; i < 26; i++) {
+            if(node->children[i]) {
+                stack.push_back({node->children[i], depth + 1});
+                filled++;
+            }
         }
-        node = node->children[index];
+
+        while(result.depthHistogram.length() <= depth) result.depthHistogram.push_back(0);
+        result.depthHistogram[depth]++;
+        result.fillHistogram[filled]++;
+        result.nodes++;
+        if(node->isEndOfWord) keyLengthSum += depth;
+    }
+
+    size_t blocks = (values.used + CHUNK - 1) / CHUNK;
+    result.bytes += result.nodes * sizeof(Node) + blocks * sizeof(Chunk);
+    for(int level = 0; level < values.height; level++) {
+        blocks = (blocks + FANOUT - 1) / FANOUT;
+        result.bytes += blocks * sizeof(Directory);
+    }
+    if(keyCount) result.averageKeyLength = (double)keyLengthSum / keyCount;
+    return result;
+}
+
+template <typename T, typename K>
+std::string ChimpMap<T, K>::Stats::toText() const {
+    std::ostringstream out;
+    out << "keys: " << keys << "\nnodes: " << nodes << "\nbytes: " << bytes
+        << "\naverage key length: " << averageKeyLength << "\nfill histogram:";
+    for(int i = 0; i < 27; i++) {
+        if(fillHistogram[i]) out << " " << i << "=" << fillHistogram[i];
+    }
+    out << "\ndepth histogram:";
+    for(size_t i = 0; i < depthHistogram.length(); i++) {
+        out << " " << i << "=" << depthHistogram[i];
+    }
+    out << "\n";
+    return out.str();
+}
+
+template <typename T, typename K>
+std::string ChimpMap<T, K>::Stats::toJSON() const {
+    std::ostringstream out;
+    out << "{\"keys\":" << keys << ",\"nodes\":" << nodes << ",\"bytes\":" << bytes
+        << ",\"averageKeyLength\":" << averageKeyLength << ",\"fillHistogram\":[";
+    for(int i = 0; i < 27; i++) {
+        out << (i ? "," : "") << fillHistogram[i];
+    }
+    out << "],\"depthHistogram\":[";
+    for(size_t i = 0; i < depthHistogram.length(); i++) {
+        out << (i ? "," : "") << depthHistogram[i];
+    }
+    out << "]}";
+    return out.str();
+}
+#endif
+
+template <typename T, typename K>
+std::pair<T*, bool> ChimpMap<T, K>::insert(std::string_view key, const T& value) {
+    return try_emplace(key, value);
+}
+
+template <typename T, typename K>
+template <class... Args>
+std::pair<T*, bool> ChimpMap<T, K>::try_emplace(std::string_view key, Args&&... args) {
+    Node* node = findOrCreate(key);
+    bool inserted = !node->isEndOfWord;
+    if(inserted) {
+        node->slot = construct(std::forward<Args>(args)...);
+        node->isEndOfWord = true;
+        keyCount++;
     }
 
-    return node->isEndOfWord;
+    return {&valueRef(node->slot), inserted};
+}
+
+template <typename T, typename K>
+template <class M>
+std::pair<T*, bool> ChimpMap<T, K>::insert_or_assign(std::string_view key, M&& value) {
+    Node* node = findOrCreate(key);
+    if(node->isEndOfWord) {
+        T& existing = valueRef(node->slot);
+        existing = std::forward<M>(value);
+        return {&existing, false};
+    }
+
+    node->slot = construct(std::forward<M>(value));
+    node->isEndOfWord = true;
+    keyCount++;
+    return {&valueRef(node->slot), true};
 }
 
-template <typename T>
-void ChimpMap<T>::erase(const Key& key) {
-    if(!root) return;
+template <typename T, typename K>
+template <class Function>
+std::pair<T*, bool> ChimpMap<T, K>::update(std::string_view key, Function fn) {
+    std::pair<T*, bool> result = try_emplace(key);
+    fn(*result.first);
+    return result;
+}
+
+template <typename T, typename K>
+T& ChimpMap<T, K>::at(std::string_view key) {
+    Node* node = find(key);
+    if(!node || node->isEndOfWord == false) {
+        std::cerr << "Key " << key << " not available." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    return valueRef(node->slot);
+}
+
+template <typename T, typename K>
+bool ChimpMap<T, K>::count(std::string_view key) const {
+    Node* node = find(key);
+    return node && node->isEndOfWord;
+}
+
+template <typename T, typename K>
+void ChimpMap<T, K>::erase(std::string_view key) {
+    if(!count(key)) return;
     
-    Node* node = root;
+    Node* node = own(root);
     Vector<std::pair<Node*, char>> path; 
 
     for(char ch : key) {
-        if(!node->children[ch - 'a']) return; 
-
         path.push_back({node, ch});
-        node = node->children[ch - 'a'];
+        node = own(node->children[ch - 'a']);
     }
 
-    if(!node->isEndOfWord) return;
-
+    destroy(node->slot);
     node->isEndOfWord = false;
+    node->slot = -1;
 
     for(int i = (int)path.length() - 1; i >= 0; i--) {
         Node* parent = path[i].first;
@@ -375,78 +949,58 @@ void ChimpMap<T>::erase(const Key& key) {
 
         if(child->isEndOfWord || !child->empty()) break; 
 
-        delete child;
+        freeNode(child);
         parent->children[ch - 'a'] = nullptr;
     }
 
     keyCount--;
 }
 
-template <typename T>
+template <typename T, typename K>
 template <class... Args>
-void ChimpMap<T>::emplace(const Key& key, Args&&... args) {
-    Node* node = root;
-    for(char ch : key) {
-        int index = ch - 'a';
-        if(!node->children[index]) {
-            node->children[index] = new Node();
-        }
-        node = node->children[index];
-    }
-    if(node->isEndOfWord == false) keyCount++;
-
-    new (&node->value) T(std::forward<Args>(args)...); 
-    node->isEndOfWord = true;  
-}
-
-template <typename T>
-T& ChimpMap<T>::operator[](const Key& key) {
-    Node* node = root;
-    for(char ch : key) {
-        int index = ch - 'a';
-        if(!node->children[index]) {
-            node->children[index] = new Node();
-        }
-        node = node->children[index];
-    }
-
+void ChimpMap<T, K>::emplace(std::string_view key, Args&&... args) {
+    Node* node = findOrCreate(key);
+    int slot = construct(std::forward<Args>(args)...);     // args may refer to the old value
     if(node->isEndOfWord == false) keyCount++;
+    else destroy(node->slot);
 
+    node->slot = slot;
     node->isEndOfWord = true;
-    return node->value;
 }
 
-template <typename T>
-const T& ChimpMap<T>::operator[](const Key& key) const {
-    Node* node = root;
-    for(char ch : key) {
-        int index = ch - 'a';
-        if(!node->children[index]) {
-            node->children[index] = new Node();
-        }
-        node = node->children[index];
-    }
+template <typename T, typename K>
+T& ChimpMap<T, K>::operator[](std::string_view key) {
+    return *try_emplace(key).first;
+}
 
-    if(node->isEndOfWord == false) {
+template <typename T, typename K>
+const T& ChimpMap<T, K>::operator[](std::string_view key) const {
+    Node* node = find(key);
+    if(!node || node->isEndOfWord == false) {
         std::cerr << "Key not found" << std::endl;
         std::exit(EXIT_FAILURE);
     }
 
-    return node->value;
+    return *values.at(node->slot);
 }
 
-template <typename T>
-ChimpMap<T>& ChimpMap<T>::operator=(const ChimpMap<T>& other) {
+template <typename T, typename K>
+ChimpMap<T, K>& ChimpMap<T, K>::operator=(const ChimpMap<T, K>& other) {
     if(this != &other) {
+        if(other.root) other.root->refCount++;
+        if(other.values.top) other.values.top->refCount++;
+        clear(root);
+        release(values);
         root = other.root;
+        values = other.values;
         keyCount = other.keyCount;
     }
     
     return *this;
 }
 
-template <typename T>
-ChimpMap<T>& ChimpMap<T>::operator=(std::initializer_list<std::pair<const Key, T>> init) {
+template <typename T, typename K>
+ChimpMap<T, K>& ChimpMap<T, K>::operator=(std::initializer_list<std::pair<const Key, T>> init) {
     clear();
     for(const auto& [key, value] : init) {
         (*this)[key] = value;
@@ -455,15 +1009,20 @@ ChimpMap<T>& ChimpMap<T>::operator=(std::initializer_list<std::pair<const Key, T
     return *this;
 }
 
-template <typename T>
-ChimpMap<T>& ChimpMap<T>::operator=(ChimpMap&& other) noexcept {
+template <typename T, typename K>
+ChimpMap<T, K>& ChimpMap<T, K>::operator=(ChimpMap&& other) noexcept {
     if(this != &other) {
+        clear(root);
+        release(values);
         root = other.root;
+        values = other.values;
         keyCount = other.keyCount;
 
         other.root = nullptr;
+        other.values = Slab();
         other.keyCount = 0;
     }
     
     return *this;
-}
\ No newline at end of file
+}
+#include "ChimpMapRadix.hpp"
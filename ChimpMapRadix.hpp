@@ -0,0 +1,733 @@
+# pragma once
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <atomic>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <initializer_list>
+#include "Vector.hpp"
+#include "Trace.hpp"
+
+// Included from ChimpMap.hpp. Integer keys as a radix trie: a key is cut into
+// fixed-width chunks, most significant first, and each chunk picks one child,
+// so a lookup walks at most width / Bits levels (8 for a uint64_t in 8-bit
+// chunks, 4 in 16-bit chunks) and never builds a key object. Signed keys have
+// their sign bit flipped on the way in, so iteration runs in numeric order.
+//
+// A node is one allocation: a header, the chunk values present as a sorted
+// label array, then children (inner levels) or values (last level) parallel to
+// it, so sparse ID spaces cost memory per key, not per possible chunk value.
+// A full node is indexed directly. Paths are compressed: a node records the
+// level it branches on and the key bits above it, and a parent links straight
+// to it past the levels where only one key prefix exists. A lone random ID
+// therefore costs one small last-level node instead of a chain of
+// single-child nodes. Nodes are shared copy-on-write exactly as in the string
+// ChimpMap, so copies and snapshot() are O(1).
+
+template <class Int, int Bits = 8>
+struct RadixKey {
+    static_assert(std::is_integral_v<Int> && !std::is_same_v<Int, bool>, "RadixKey needs an integer type");
+    static_assert(Bits == 8 || Bits == 16, "RadixKey chunks are 8 or 16 bits wide");
+    static_assert(sizeof(Int) * 8 % Bits == 0, "key width must be a multiple of the chunk width");
+};
+
+template <typename T, class Int, int Bits>
+class ChimpMap<T, RadixKey<Int, Bits>> {
+private:
+    typedef std::make_unsigned_t<Int> Ordered;      // key bits in numeric order
+    typedef std::conditional_t<Bits == 8, uint8_t, uint16_t> Label;
+
+    static constexpr int WIDTH = sizeof(Int) * 8;
+    static constexpr int LEVELS = WIDTH / Bits;
+    static constexpr int LAST = LEVELS - 1;
+    static constexpr size_t FANOUT = size_t(1) << Bits;
+
+    // Header of a node; its labels and then its children or values follow in
+    // the same allocation, each array aligned for ALIGN.
+    struct Node {
+        std::atomic<int> refCount;      // number of maps / parents sharing this node
+        int level;                      // chunk its labels stand for; LAST holds values
+        int count;                      // entries in use
+        int capacity;                   // entries allocated
+        Ordered prefix;                 // key bits above level, shared by every key below
+
+        Node(int level, Ordered prefix, int capacity) : refCount(1), level(level), count(0), capacity(capacity), prefix(prefix) {}
+    };
+
+    static constexpr size_t ALIGN = std::max({alignof(Node), alignof(Node*), alignof(T)});
+
+    static size_t roundUp(size_t bytes) { return (bytes + ALIGN - 1) / ALIGN * ALIGN; }
+    static size_t slotsOffset(int capacity) { return roundUp(sizeof(Node)) + roundUp(capacity * sizeof(Label)); }
+    static size_t nodeBytes(int level, int capacity) {
+        return slotsOffset(capacity) + capacity * (level == LAST ? sizeof(T) : sizeof(Node*));
+    }
+
+    static Label* labels(const Node* node) {
+        return reinterpret_cast<Label*>(reinterpret_cast<char*>(const_cast<Node*>(node)) + roundUp(sizeof(Node)));
+    }
+    static Node** children(const Node* node) {
+        return reinterpret_cast<Node**>(reinterpret_cast<char*>(const_cast<Node*>(node)) + slotsOffset(node->capacity));
+    }
+    static T* values(const Node* node) {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(const_cast<Node*>(node)) + slotsOffset(node->capacity));
+    }
+
+    Node* root;
+    int keyCount;
+
+#ifdef CHIMPSTL_TRACE
+    mutable TraceCounters traceCounters;
+    void trace(TraceEvent event, size_t amount) const { recordTrace(traceCounters, event, this, amount); }
+#else
+    void trace(TraceEvent, size_t) const {}
+#endif
+
+    Node* createNode(int level, Ordered prefix, int capacity) {
+        size_t bytes = nodeBytes(level, capacity);
+        trace(TraceEvent::NodeCreate, bytes);
+        void* memory;
+        if constexpr(ALIGN > __STDCPP_DEFAULT_NEW_ALIGNMENT__) memory = ::operator new(bytes, std::align_val_t(ALIGN));
+        else memory = ::operator new(bytes);
+        return new (memory) Node(level, above(prefix, level), capacity);
+    }
+
+    // Returns the memory of node; its values must already be destroyed or moved out.
+    void releaseNode(Node* node) {
+        trace(TraceEvent::NodeFree, nodeBytes(node->level, node->capacity));
+        node->~Node();
+        if constexpr(ALIGN > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(node, std::align_val_t(ALIGN));
+        else ::operator delete(node);
+    }
+
+    void freeNode(Node* node) {
+        if(node->level == LAST) std::destroy_n(values(node), node->count);
+        releaseNode(node);
+    }
+
+    static Ordered order(Int key) {
+        Ordered bits = (Ordered)key;
+        if(std::is_signed_v<Int>) bits ^= Ordered(Ordered(1) << (WIDTH - 1));
+        return bits;
+    }
+
+    static Int unorder(Ordered bits) {
+        if(std::is_signed_v<Int>) bits ^= Ordered(Ordered(1) << (WIDTH - 1));
+        return (Int)bits;
+    }
+
+    static Label chunk(Ordered bits, int level) { return Label(bits >> (WIDTH - Bits * (level + 1))); }
+
+    // bits with every chunk from level down cleared.
+    static Ordered above(Ordered bits, int level) {
+        return level == 0 ? Ordered(0) : Ordered(bits & ~(Ordered(~Ordered(0)) >> (Bits * level)));
+    }
+
+    static int lowerBound(const Node* node, Label label);
+    static bool matches(const Node* node, int index, Label label) {
+        return index < node->count && labels(node)[index] == label;
+    }
+
+    void grow(Node*& slot, Node* bigger);
+    void insertChild(Node*& slot, int index, Label label, Node* child);
+    template <class... Args>
+    T& insertValue(Node*& slot, int index, Label label, Args&&... args);
+    static void eraseEntry(Node* node, int index);
+
+    Node* own(Node*& slot);
+    const T* find(Ordered bits) const;
+    template <class... Args>
+    T& findOrCreate(Ordered bits, bool& created, Args&&... args);
+    template <class... Args>
+    Node* createLeaf(Ordered bits, Args&&... args);
+
+public:
+    typedef Int key_type;
+
+    // CONSTRUCTORS
+
+    // 1. Default Constructor
+    ChimpMap() {
+        root = createNode(0, 0, 0);
+        keyCount = 0;
+    }
+
+    // 2. Copy Constructor (O(1), shares every node with other)
+    ChimpMap(const ChimpMap& other) {
+        root = other.root;
+        if(root) root->refCount++;
+        keyCount = other.keyCount;
+    }
+
+    // 3. Brace-enclosed initialized list Constructor
+    ChimpMap(std::initializer_list<std::pair<const Int, T>> init) : ChimpMap() {
+        for(const auto& [key, value] : init) {
+            (*this)[key] = value;
+        }
+    }
+
+    // 4. Move Constructor
+    ChimpMap(ChimpMap&& other) noexcept {
+        root = other.root;
+        keyCount = other.keyCount;
+
+        other.root = nullptr;
+        other.keyCount = 0;
+    }
+
+    // ITERATOR
+    // Read-only, in ascending key order. Values are written through
+    // operator[], which first copies any nodes shared with snapshots.
+    struct Iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = std::pair<Int, T>;
+        using reference         = std::pair<Int, const T&>;
+
+        struct Arrow {
+            reference ref;
+            reference* operator->() { return &ref; }
+        };
+
+        Iterator() : nodes(), index(), depth(0), valid(false) {}
+
+        reference operator*() const { return reference(key(), values(nodes[depth - 1])[index[depth - 1]]); }
+        Arrow operator->() const { return Arrow{**this}; }
+
+        Iterator& operator++() { advance(depth - 1); return *this; }
+        Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) {
+            if(!a.valid || !b.valid) return a.valid == b.valid;
+            return a.nodes[a.depth - 1] == b.nodes[b.depth - 1] && a.index[a.depth - 1] == b.index[b.depth - 1];
+        }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return !(a == b); }
+
+    private:
+        friend class ChimpMap;
+        const Node* nodes[LEVELS];      // path from the root; nodes[depth - 1] holds the value
+        int index[LEVELS];              // position taken in each node
+        int depth;
+        bool valid;
+
+        Int key() const {
+            const Node* node = nodes[depth - 1];
+            return unorder(Ordered(node->prefix | labels(node)[index[depth - 1]]));
+        }
+
+        // Follows the first child from nodes[at] down to a last-level node.
+        void descend(int at) {
+            for(; nodes[at]->level != LAST; at++) {
+                nodes[at + 1] = children(nodes[at])[index[at]];
+                index[at + 1] = 0;
+            }
+            depth = at + 1;
+            valid = true;
+        }
+
+        // Moves to the next entry in nodes[at] or, once that node is exhausted, above it.
+        void advance(int at) {
+            for(; at >= 0; at--) {
+                if(++index[at] < nodes[at]->count) {
+                    descend(at);
+                    return;
+                }
+            }
+            valid = false;
+        }
+    };
+
+    Iterator begin() const;
+    Iterator end()   const { return Iterator(); }
+    Iterator cbegin() const { return begin(); }
+    Iterator cend()   const { return end();   }
+
+    // MEMBER FUNCTIONS
+    size_t length() const { return keyCount;      }
+    bool empty()    const { return keyCount == 0; }
+
+    // Point-in-time view of the map, O(1) as for string keys.
+    ChimpMap snapshot() const { return ChimpMap(*this); }
+
+    // Single-walk upserts, as for string keys: each returns a pointer to the
+    // key's value and whether the key was added.
+    std::pair<T*, bool> insert(Int key, const T& value);
+    template <class... Args>
+    std::pair<T*, bool> try_emplace(Int key, Args&&... args);
+    template <class M>
+    std::pair<T*, bool> insert_or_assign(Int key, M&& value);
+    template <class Function>
+    std::pair<T*, bool> update(Int key, Function fn);
+
+    T& at(Int key);
+    bool count(Int key) const { return find(order(key)) != nullptr; }
+    void erase(Int key);
+    void clear() {
+        clear(root);
+        root = createNode(0, 0, 0);
+        keyCount = 0;
+    }
+
+    template <class... Args>
+    void emplace(Int key, Args&&... args);
+
+    // First entry with a key not less / greater than key.
+    Iterator lower_bound(Int key) const { return lowerBoundOrdered(order(key)); }
+    Iterator upper_bound(Int key) const;
+
+    // Entries whose top prefixBits bits equal those of prefix, as a
+    // [first, last) pair: prefix_range(0x1234000000000000, 16) spans every
+    // key starting 0x1234. Costs two lower_bound descents.
+    std::pair<Iterator, Iterator> prefix_range(Int prefix, int prefixBits) const;
+
+#ifdef CHIMPSTL_TRACE
+    const TraceCounters& trace_counters() const { return traceCounters; }
+#endif
+
+    // OVERLOADED OPERATORS
+    T& operator[](Int key);
+    const T& operator[](Int key) const;
+
+    ChimpMap& operator=(const ChimpMap& other);     /* Copy Assignment Operator */
+    ChimpMap& operator=(std::initializer_list<std::pair<const Int, T>> init);
+    ChimpMap& operator=(ChimpMap&& other) noexcept; /* Move Assignment Operator */
+
+    ~ChimpMap() {
+        clear(root);
+    }
+
+
+private:
+    Iterator lowerBoundOrdered(Ordered bits) const;
+
+    static int grownCapacity(int capacity) { return (int)std::min<size_t>(FANOUT, capacity ? 2 * capacity : 1); }
+
+    void clear(Node* node) {                 // drops one reference to node
+        if(!node || --node->refCount > 0) return;
+        if(node->level != LAST) {
+            for(int i = 0; i < node->count; i++) clear(children(node)[i]);
+        }
+        freeNode(node);
+    }
+};
+
+// Position of the first label >= label: the branchless search FlatMap uses,
+// or the label itself when the node holds every chunk value.
+template <typename T, class Int, int Bits>
+int ChimpMap<T, RadixKey<Int, Bits>>::lowerBound(const Node* node, Label label) {
+    size_t n = node->count;
+    if(n == FANOUT) return label;
+    if(n == 0) return 0;
+
+    const Label* first = labels(node);
+    const Label* base = first;
+    while(n > 1) {
+        size_t half = n / 2;
+        base = base[half] < label ? base + half : base;
+        n -= half;
+    }
+    return (base - first) + (*base < label);
+}
+
+// Moves the entries of slot into bigger, an empty node of the same level and
+// prefix, and puts bigger in its place. A value already built past the
+// entries in bigger is left alone.
+template <typename T, class Int, int Bits>
+void ChimpMap<T, RadixKey<Int, Bits>>::grow(Node*& slot, Node* bigger) {
+    Node* node = slot;
+    std::memcpy(labels(bigger), labels(node), node->count * sizeof(Label));
+    if(node->level == LAST) {
+        std::uninitialized_move_n(values(node), node->count, values(bigger));
+        std::destroy_n(values(node), node->count);
+    }
+    else {
+        std::memcpy(children(bigger), children(node), node->count * sizeof(Node*));
+    }
+    bigger->count = node->count;
+    releaseNode(node);
+    slot = bigger;
+}
+
+template <typename T, class Int, int Bits>
+void ChimpMap<T, RadixKey<Int, Bits>>::insertChild(Node*& slot, int index, Label label, Node* child) {
+    if(slot->count == slot->capacity) grow(slot, createNode(slot->level, slot->prefix, grownCapacity(slot->capacity)));
+
+    Node* node = slot;
+    Label* l = labels(node);
+    Node** c = children(node);
+    std::memmove(l + index + 1, l + index, (node->count - index) * sizeof(Label));
+    std::memmove(c + index + 1, c + index, (node->count - index) * sizeof(Node*));
+    l[index] = label;
+    c[index] = child;
+    node->count++;
+}
+
+// Inserts T(args...) at index. The value is built in the first free slot
+// (of the grown node when this one is full) before any entry moves, so an
+// argument that names an entry of this node is still intact, and is then
+// rotated into place.
+template <typename T, class Int, int Bits>
+template <class... Args>
+T& ChimpMap<T, RadixKey<Int, Bits>>::insertValue(Node*& slot, int index, Label label, Args&&... args) {
+    Node* node = slot;
+    Node* target = node->count == node->capacity ? createNode(node->level, node->prefix, grownCapacity(node->capacity)) : node;
+    T* last = values(target) + node->count;
+    new (last) T(std::forward<Args>(args)...);
+    if(target != node) grow(slot, target);
+
+    node = slot;
+    T* v = values(node);
+    if(index < node->count) {
+        T value(std::move(*last));
+        std::move_backward(v + index, last, last + 1);
+        v[index] = std::move(value);
+    }
+
+    Label* l = labels(node);
+    std::memmove(l + index + 1, l + index, (node->count - index) * sizeof(Label));
+    l[index] = label;
+    node->count++;
+    return v[index];
+}
+
+template <typename T, class Int, int Bits>
+void ChimpMap<T, RadixKey<Int, Bits>>::eraseEntry(Node* node, int index) {
+    int tail = node->count - index - 1;
+    Label* l = labels(node);
+    std::memmove(l + index, l + index + 1, tail * sizeof(Label));
+    if(node->level == LAST) {
+        T* v = values(node);
+        std::move(v + index + 1, v + node->count, v + index);
+        std::destroy_at(v + node->count - 1);
+    }
+    else {
+        Node** c = children(node);
+        std::memmove(c + index, c + index + 1, tail * sizeof(Node*));
+    }
+    node->count--;
+}
+
+template <typename T, class Int, int Bits>
+typename ChimpMap<T, RadixKey<Int, Bits>>::Node* ChimpMap<T, RadixKey<Int, Bits>>::own(Node*& slot) {
+    if(slot->refCount > 1) {
+        Node* node = slot;
+        Node* copy = createNode(node->level, node->prefix, node->capacity);
+        std::memcpy(labels(copy), labels(node), node->count * sizeof(Label));
+        if(node->level == LAST) {
+            std::uninitialized_copy_n(values(node), node->count, values(copy));
+        }
+        else {
+            std::memcpy(children(copy), children(node), node->count * sizeof(Node*));
+            for(int i = 0; i < node->count; i++) children(copy)[i]->refCount++;
+        }
+        copy->count = node->count;
+        clear(slot);                    // frees it if the other owners let go meanwhile
+        slot = copy;
+    }
+    return slot;
+}
+
+// Skips the prefix checks on the way down: the last-level node's prefix holds
+// every bit above its own chunk, so one comparison there settles a hit.
+template <typename T, class Int, int Bits>
+const T* ChimpMap<T, RadixKey<Int, Bits>>::find(Ordered bits) const {
+    const Node* node = root;
+    while(true) {
+        Label label = chunk(bits, node->level);
+        int i = lowerBound(node, label);
+        if(!matches(node, i, label)) return nullptr;
+        if(node->level == LAST) return node->prefix == above(bits, LAST) ? &values(node)[i] : nullptr;
+        node = children(node)[i];
+    }
+}
+
+// A last-level node holding only bits' key, with a value built from args.
+template <typename T, class Int, int Bits>
+template <class... Args>
+typename ChimpMap<T, RadixKey<Int, Bits>>::Node* ChimpMap<T, RadixKey<Int, Bits>>::createLeaf(Ordered bits, Args&&... args) {
+    Node* leaf = createNode(LAST, bits, 1);
+    new (values(leaf)) T(std::forward<Args>(args)...);
+    labels(leaf)[0] = chunk(bits, LAST);
+    leaf->count = 1;
+    return leaf;
+}
+
+// Walks to key's value, adding the key with a value built from args if absent.
+// A missing chunk gets a leaf linked straight below the node that misses it;
+// a key that leaves a compressed path gets a two-way node where it branches.
+template <typename T, class Int, int Bits>
+template <class... Args>
+T& ChimpMap<T, RadixKey<Int, Bits>>::findOrCreate(Ordered bits, bool& created, Args&&... args) {
+    Node** slot = &root;
+    Node* node = own(root);
+    while(node->level != LAST) {
+        Label label = chunk(bits, node->level);
+        int i = lowerBound(node, label);
+        if(!matches(node, i, label)) {
+            Node* leaf = createLeaf(bits, std::forward<Args>(args)...);
+            insertChild(*slot, i, label, leaf);
+            created = true;
+            keyCount++;
+            return values(leaf)[0];
+        }
+
+        Node*& next = children(node)[i];
+        if(above(bits, next->level) != next->prefix) {
+            int level = node->level + 1;
+            while(chunk(bits, level) == chunk(next->prefix, level)) level++;
+
+            Node* leaf = createLeaf(bits, std::forward<Args>(args)...);
+            Node* branch = createNode(level, bits, 2);
+            int first = chunk(bits, level) < chunk(next->prefix, level) ? 0 : 1;
+            labels(branch)[first] = chunk(bits, level);
+            children(branch)[first] = leaf;
+            labels(branch)[1 - first] = chunk(next->prefix, level);
+            children(branch)[1 - first] = next;
+            branch->count = 2;
+            next = branch;
+            created = true;
+            keyCount++;
+            return values(leaf)[0];
+        }
+
+        slot = &next;
+        node = own(next);
+    }
+
+    Label label = chunk(bits, LAST);
+    int i = lowerBound(node, label);
+    created = !matches(node, i, label);
+    if(!created) return values(node)[i];
+
+    keyCount++;
+    return insertValue(*slot, i, label, std::forward<Args>(args)...);
+}
+
+template <typename T, class Int, int Bits>
+typename ChimpMap<T, RadixKey<Int, Bits>>::Iterator ChimpMap<T, RadixKey<Int, Bits>>::begin() const {
+    Iterator it;
+    if(root->count == 0) return it;
+
+    it.nodes[0] = root;
+    it.index[0] = 0;
+    it.descend(0);
+    return it;
+}
+
+template <typename T, class Int, int Bits>
+typename ChimpMap<T, RadixKey<Int, Bits>>::Iterator ChimpMap<T, RadixKey<Int, Bits>>::lowerBoundOrdered(Ordered bits) const {
+    Iterator it;
+    it.nodes[0] = root;
+    for(int at = 0; ; at++) {
+        const Node* node = it.nodes[at];
+        Ordered prefix = above(bits, node->level);
+        if(prefix != node->prefix) {                    // the compressed path skips past bits
+            it.index[at] = 0;
+            if(node->prefix > prefix) {                 // everything below is larger
+                it.descend(at);
+                return it;
+            }
+            it.advance(at - 1);                         // everything below is smaller
+            return it;
+        }
+
+        Label label = chunk(bits, node->level);
+        int i = lowerBound(node, label);
+        it.index[at] = i;
+
+        if(i == node->count) {                          // everything here is smaller
+            if(at == 0) return Iterator();
+            it.advance(at - 1);
+            return it;
+        }
+        if(labels(node)[i] != label || node->level == LAST) {   // everything below is larger, or bits itself
+            it.descend(at);
+            return it;
+        }
+        it.nodes[at + 1] = children(node)[i];
+    }
+}
+
+template <typename T, class Int, int Bits>
+typename ChimpMap<T, RadixKey<Int, Bits>>::Iterator ChimpMap<T, RadixKey<Int, Bits>>::upper_bound(Int key) const {
+    Ordered bits = order(key);
+    if(bits == Ordered(~Ordered(0))) return end();
+    return lowerBoundOrdered(bits + 1);
+}
+
+template <typename T, class Int, int Bits>
+std::pair<typename ChimpMap<T, RadixKey<Int, Bits>>::Iterator, typename ChimpMap<T, RadixKey<Int, Bits>>::Iterator>
+ChimpMap<T, RadixKey<Int, Bits>>::prefix_range(Int prefix, int prefixBits) const {
+    if(prefixBits < 0 || prefixBits > WIDTH) {
+        std::cerr << "Prefix of " << prefixBits << " bits on a " << WIDTH << "-bit key." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    Ordered low = prefixBits == WIDTH ? 0 : Ordered(~uint64_t(0) >> (64 - (WIDTH - prefixBits)));
+    Ordered first = order(prefix) & Ordered(~low);
+    Ordered last = first | low;
+    return {lowerBoundOrdered(first), last == Ordered(~Ordered(0)) ? end() : lowerBoundOrdered(last + 1)};
+}
+
+template <typename T, class Int, int Bits>
+std::pair<T*, bool> ChimpMap<T, RadixKey<Int, Bits>>::insert(Int key, const T& value) {
+    return try_emplace(key, value);
+}
+
+template <typename T, class Int, int Bits>
+template <class... Args>
+std::pair<T*, bool> ChimpMap<T, RadixKey<Int, Bits>>::try_emplace(Int key, Args&&... args) {
+    bool created;
+    T& value = findOrCreate(order(key), created, std::forward<Args>(args)...);
+    return {&value, created};
+}
+
+template <typename T, class Int, int Bits>
+template <class M>
+std::pair<T*, bool> ChimpMap<T, RadixKey<Int, Bits>>::insert_or_assign(Int key, M&& value) {
+    bool created;
+    T& existing = findOrCreate(order(key), created, std::forward<M>(value));   // consumed only if created
+    if(!created) existing = std::forward<M>(value);
+    return {&existing, created};
+}
+
+template <typename T, class Int, int Bits>
+template <class Function>
+std::pair<T*, bool> ChimpMap<T, RadixKey<Int, Bits>>::update(Int key, Function fn) {
+    std::pair<T*, bool> result = try_emplace(key);
+    fn(*result.first);
+    return result;
+}
+
+template <typename T, class Int, int Bits>
+T& ChimpMap<T, RadixKey<Int, Bits>>::at(Int key) {
+    if(!count(key)) {
+        std::cerr << "Key " << +key << " not available." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    bool created;
+    return findOrCreate(order(key), created);       // owns the path before handing out a reference
+}
+
+// Removes the key's value, drops its last-level node if that empties it, and
+// folds an inner node left with one child into its parent's link, so every
+// inner node below the root keeps branching.
+template <typename T, class Int, int Bits>
+void ChimpMap<T, RadixKey<Int, Bits>>::erase(Int key) {
+    if(!count(key)) return;
+
+    Ordered bits = order(key);
+    Node** slots[LEVELS];
+    int index[LEVELS];
+    int depth = 0;
+    Node** slot = &root;
+    Node* node = own(root);
+    while(true) {
+        slots[depth] = slot;
+        index[depth] = lowerBound(node, chunk(bits, node->level));
+        if(node->level == LAST) break;
+        slot = &children(node)[index[depth++]];
+        node = own(*slot);
+    }
+
+    eraseEntry(node, index[depth]);
+    if(node->count == 0 && depth > 0) {
+        Node* parent = *slots[depth - 1];
+        freeNode(node);
+        eraseEntry(parent, index[depth - 1]);
+        if(depth > 1 && parent->count == 1) {
+            *slots[depth - 1] = children(parent)[0];
+            freeNode(parent);
+        }
+    }
+
+    keyCount--;
+}
+
+template <typename T, class Int, int Bits>
+template <class... Args>
+void ChimpMap<T, RadixKey<Int, Bits>>::emplace(Int key, Args&&... args) {
+    bool created;
+    T& value = findOrCreate(order(key), created, std::forward<Args>(args)...);   // consumed only if created
+    if(!created) {
+        T replacement(std::forward<Args>(args)...);
+        value = std::move(replacement);
+    }
+}
+
+template <typename T, class Int, int Bits>
+T& ChimpMap<T, RadixKey<Int, Bits>>::operator[](Int key) {
+    return *try_emplace(key).first;
+}
+
+template <typename T, class Int, int Bits>
+const T& ChimpMap<T, RadixKey<Int, Bits>>::operator[](Int key) const {
+    const T* value = find(order(key));
+    if(!value) {
+        std::cerr << "Key not found" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    return *value;
+}
+
+template <typename T, class Int, int Bits>
+ChimpMap<T, RadixKey<Int, Bits>>& ChimpMap<T, RadixKey<Int, Bits>>::operator=(const ChimpMap& other) {
+    if(this != &other) {
+        if(other.root) other.root->refCount++;
+        clear(root);
+        root = other.root;
+        keyCount = other.keyCount;
+    }
+
+    return *this;
+}
+
+template <typename T, class Int, int Bits>
+ChimpMap<T, RadixKey<Int, Bits>>& ChimpMap<T, RadixKey<Int, Bits>>::operator=(std::initializer_list<std::pair<const Int, T>> init) {
+    clear();
+    for(const auto& [key, value] : init) {
+        (*this)[key] = value;
+    }
+    return *this;
+}
+
+template <typename T, class Int, int Bits>
+ChimpMap<T, RadixKey<Int, Bits>>& ChimpMap<T, RadixKey<Int, Bits>>::operator=(ChimpMap&& other) noexcept {
+    if(this != &other) {
+        clear(root);
+        root = other.root;
+        keyCount = other.keyCount;
+
+        other.root = nullptr;
+        other.keyCount = 0;
+    }
+
+    return *this;
+}
+
+#if __cplusplus >= 202002L
+// ChimpMap<T, uint64_t> is ChimpMap<T, RadixKey<uint64_t>>: 8-bit chunks.
+template <typename T, class Int>
+    requires (std::is_integral_v<Int> && !std::is_same_v<Int, bool>)
+class ChimpMap<T, Int> : public ChimpMap<T, RadixKey<Int>> {
+    typedef ChimpMap<T, RadixKey<Int>> Radix;
+
+public:
+    using Radix::Radix;
+    using Radix::operator=;
+
+    ChimpMap() = default;
+    ChimpMap(const ChimpMap&) = default;
+    ChimpMap(ChimpMap&&) noexcept = default;
+    ChimpMap& operator=(const ChimpMap&) = default;
+    ChimpMap& operator=(ChimpMap&&) noexcept = default;
+
+    ChimpMap snapshot() const { return ChimpMap(*this); }
+};
+#endif
@@ -0,0 +1,177 @@
+# pragma once
+#include <string>
+#include <iostream>
+#include <unordered_set>
+#include <functional>
+#include "Vector.hpp"
+#include "Trace.hpp"
+
+struct DawgNode {
+    DawgNode* children[26];
+    bool isEndOfWord;
+
+    DawgNode() : isEndOfWord(false) {
+        for (int i = 0; i < 26; ++i) {
+            children[i] = nullptr;
+        }
+    }
+};
+
+// Minimal acyclic automaton (DAWG) over a word list given in sorted order.
+// Built incrementally with Daciuk's algorithm: once a new word diverges from
+// the previous one, the previous word's tail can no longer change, so its
+// nodes are replaced by an equivalent node from the registry (same finality,
+// same children) or registered themselves. Shared endings like -ing or -tion
+// are therefore stored once.
+class Dawg {
+private:
+    struct Hash {
+        size_t operator()(const DawgNode* node) const {
+            size_t h = node->isEndOfWord;
+            for (int i = 0; i < 26; i++) {
+                h = h * 1000003 ^ std::hash<const DawgNode*>()(node->children[i]);
+            }
+            return h;
+        }
+    };
+
+    struct Equal {
+        bool operator()(const DawgNode* a, const DawgNode* b) const {
+            if (a->isEndOfWord != b->isEndOfWord) return false;
+            for (int i = 0; i < 26; i++) {
+                if (a->children[i] != b->children[i]) return false;
+            }
+            return true;
+        }
+    };
+
+    struct Edge {
+        DawgNode* parent;
+        int letter;
+        DawgNode* child;
+    };
+
+    DawgNode* root;
+    std::unordered_set<DawgNode*, Hash, Equal> registry;
+    Vector<Edge> unchecked;          // path of the last word not yet minimized
+    std::string previousWord;
+    int wordCount;
+    bool finished;                   // set by finish(); the automaton is then read-only
+
+#ifdef CHIMPSTL_TRACE
+    mutable TraceCounters traceCounters;
+    void trace(TraceEvent event, size_t amount) const { recordTrace(traceCounters, event, this, amount); }
+#else
+    void trace(TraceEvent, size_t) const {}
+#endif
+
+    DawgNode* createNode() {
+        trace(TraceEvent::NodeCreate, sizeof(DawgNode));
+        return new DawgNode();
+    }
+
+    void freeNode(DawgNode* node) {
+        trace(TraceEvent::NodeFree, sizeof(DawgNode));
+        delete node;
+    }
+
+    // Replaces or registers the unchecked nodes deeper than downTo, deepest first.
+    void minimize(int downTo) {
+        while ((int)unchecked.length() > downTo) {
+            Edge edge = unchecked.back();
+            unchecked.pop_back();
+
+            auto found = registry.find(edge.child);
+            if (found != registry.end()) {
+                edge.parent->children[edge.letter] = *found;
+                freeNode(edge.child);
+            }
+            else {
+                registry.insert(edge.child);
+            }
+        }
+    }
+
+    DawgNode* walk(const std::string& prefix) const {
+        DawgNode* node = root;
+        for (char ch : prefix) {
+            unsigned index = (unsigned char)ch - 'a';
+            if (index >= 26 || !node->children[index]) return nullptr;
+            node = node->children[index];
+        }
+        return node;
+    }
+
+public:
+    Dawg() {
+        root = createNode();
+        wordCount = 0;
+        finished = false;
+    }
+    Dawg(const Dawg&) = delete;
+    Dawg& operator=(const Dawg&) = delete;
+    ~Dawg() {
+        minimize(0);
+        for (DawgNode* node : registry) freeNode(node);
+        freeNode(root);
+    }
+
+    // Words must arrive in lexicographic order; repeating the previous word is a no-op.
+    void insert(const std::string& word) {
+        if (finished) {
+            std::cerr << "Dawg is sealed by finish(), cannot insert: " << word << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        if (wordCount > 0 && word <= previousWord) {
+            if (word == previousWord) return;
+            std::cerr << "Dawg words must be inserted in sorted order: " << word << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        int common = 0;
+        while (common < (int)word.size() && common < (int)previousWord.size() && word[common] == previousWord[common]) {
+            common++;
+        }
+        minimize(common);
+
+        DawgNode* node = unchecked.empty() ? root : unchecked.back().child;
+        for (int i = common; i < (int)word.size(); i++) {
+            DawgNode* next = createNode();
+            int letter = word[i] - 'a';
+            node->children[letter] = next;
+            unchecked.push_back({node, letter, next});
+            node = next;
+        }
+        node->isEndOfWord = true;
+
+        previousWord = word;
+        wordCount++;
+    }
+
+    // Minimizes the tail of the last word and seals the Dawg: its nodes are
+    // now shared through the registry, so any later insert() exits with an
+    // error. Queries are correct without it, but the last word's nodes are not
+    // shared until it is called.
+    void finish() {
+        minimize(0);
+        finished = true;
+    }
+
+    bool contains(const std::string& word) const {
+        DawgNode* node = walk(word);
+        return node && node->isEndOfWord;
+    }
+
+    bool starts_with(const std::string& prefix) const {
+        return walk(prefix) != nullptr;
+    }
+
+    size_t length() const { return wordCount; }
+
+#ifdef CHIMPSTL_TRACE
+    const TraceCounters& trace_counters() const { return traceCounters; }
+#endif
+
+    // Distinct nodes currently held, root included.
+    size_t node_count() const { return registry.size() + unchecked.length() + 1; }
+};
@@ -0,0 +1,440 @@
+# pragma once
+#include <iterator>
+#include <cstddef>
+#include <iostream>
+#include <functional>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+#include "Vector.hpp"
+
+// Ordered map over two parallel sorted Vectors, one of keys and one of values.
+// Meant for small and medium maps: it holds no per-key nodes, iteration is a
+// linear scan of two arrays, and any key type ordered by Compare works. A search
+// touches about log2(n) keys in one contiguous array; with integer keys that is
+// several times faster than std::map, with strings each step costs a compare.
+//
+// Lookups use a branchless binary search (the loop body is a conditional move,
+// so there is nothing for the branch predictor to miss). Single inserts and
+// erases shift the tail, O(n); for many keys at once use insert_sorted(),
+// insert(first, last) or merge(), which merge in one O(n + m) pass.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class FlatMap {
+private:
+    Vector<Key> keys;
+    Vector<T> values;
+    Compare compare;
+
+    size_t lowerBound(const Key& key) const;
+    bool matches(size_t index, const Key& key) const {
+        return index < keys.length() && !compare(key, keys.data()[index]);
+    }
+    void insertAt(size_t index, const Key& key, T&& value);
+    void mergeSorted(Vector<Key>& batchKeys, Vector<T>& batchValues);
+
+public:
+    // CONSTRUCTORS
+
+    // 1. Default Constructor
+    FlatMap(const Compare& compare = Compare()) : compare(compare) {}
+
+    // 2. Copy Constructor
+    FlatMap(const FlatMap& other) : compare(other.compare) {
+        keys = other.keys;
+        values = other.values;
+    }
+
+    // 3. Brace-enclosed initialized list Constructor (a repeated key keeps its last value)
+    FlatMap(std::initializer_list<std::pair<const Key, T>> init, const Compare& compare = Compare()) : compare(compare) {
+        for(const auto& [key, value] : init) {
+            (*this)[key] = value;
+        }
+    }
+
+    // 4. Move Constructor
+    FlatMap(FlatMap&& other) noexcept
+        : keys(std::move(other.keys)), values(std::move(other.values)), compare(std::move(other.compare)) {}
+
+    // ITERATOR
+    // Random access, in key order. Dereferencing yields a pair of references
+    // into the two arrays; the key half is const.
+    struct Iterator {
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = std::pair<Key, T>;
+        using reference         = std::pair<const Key&, T&>;
+
+        struct Arrow {
+            reference ref;
+            reference* operator->() { return &ref; }
+        };
+
+        Iterator(const Key* key = nullptr, T* value = nullptr) : key(key), value(value) {}
+
+        reference operator*() const { return reference(*key, *value); }
+        Arrow operator->() const { return Arrow{**this}; }
+        reference operator[](difference_type n) const { return reference(key[n], value[n]); }
+
+        Iterator& operator++() { key++; value++; return *this; }
+        Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
+        Iterator& operator--() { key--; value--; return *this; }
+        Iterator operator--(int) { Iterator tmp = *this; --(*this); return tmp; }
+
+        Iterator operator+(difference_type n) const { return Iterator(key + n, value + n); }
+        Iterator operator-(difference_type n) const { return Iterator(key - n, value - n); }
+        difference_type operator-(const Iterator& other) const { return key - other.key; }
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+
+        Iterator& operator+=(difference_type n) { key += n; value += n; return *this; }
+        Iterator& operator-=(difference_type n) { key -= n; value -= n; return *this; }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.key == b.key; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.key != b.key; }
+        friend bool operator< (const Iterator& a, const Iterator& b) { return a.key < b.key; }
+        friend bool operator> (const Iterator& a, const Iterator& b) { return a.key > b.key; }
+        friend bool operator<=(const Iterator& a, const Iterator& b) { return a.key <= b.key; }
+        friend bool operator>=(const Iterator& a, const Iterator& b) { return a.key >= b.key; }
+
+    private:
+        friend struct ConstIterator;
+        const Key* key;
+        T* value;
+    };
+
+    struct ConstIterator {
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = std::pair<Key, T>;
+        using reference         = std::pair<const Key&, const T&>;
+
+        struct Arrow {
+            reference ref;
+            reference* operator->() { return &ref; }
+        };
+
+        ConstIterator(const Key* key = nullptr, const T* value = nullptr) : key(key), value(value) {}
+        ConstIterator(const Iterator& it) : key(it.key), value(it.value) {}
+
+        reference operator*() const { return reference(*key, *value); }
+        Arrow operator->() const { return Arrow{**this}; }
+        reference operator[](difference_type n) const { return reference(key[n], value[n]); }
+
+        ConstIterator& operator++() { key++; value++; return *this; }
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
+        ConstIterator& operator--() { key--; value--; return *this; }
+        ConstIterator operator--(int) { ConstIterator tmp = *this; --(*this); return tmp; }
+
+        ConstIterator operator+(difference_type n) const { return ConstIterator(key + n, value + n); }
+        ConstIterator operator-(difference_type n) const { return ConstIterator(key - n, value - n); }
+        difference_type operator-(const ConstIterator& other) const { return key - other.key; }
+        friend ConstIterator operator+(difference_type n, const ConstIterator& it) { return it + n; }
+
+        ConstIterator& operator+=(difference_type n) { key += n; value += n; return *this; }
+        ConstIterator& operator-=(difference_type n) { key -= n; value -= n; return *this; }
+
+        friend bool operator==(const ConstIterator& a, const ConstIterator& b) { return a.key == b.key; }
+        friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return a.key != b.key; }
+        friend bool operator< (const ConstIterator& a, const ConstIterator& b) { return a.key < b.key; }
+        friend bool operator> (const ConstIterator& a, const ConstIterator& b) { return a.key > b.key; }
+        friend bool operator<=(const ConstIterator& a, const ConstIterator& b) { return a.key <= b.key; }
+        friend bool operator>=(const ConstIterator& a, const ConstIterator& b) { return a.key >= b.key; }
+
+    private:
+        const Key* key;
+        const T* value;
+    };
+
+    Iterator begin() { return Iterator(keys.data(), values.data()); }
+    Iterator end()   { return begin() + keys.length(); }
+    ConstIterator begin() const { return ConstIterator(keys.data(), values.data()); }
+    ConstIterator end()   const { return begin() + keys.length(); }
+    ConstIterator cbegin() const { return begin(); }
+    ConstIterator cend()   const { return end(); }
+
+    // MEMBER FUNCTIONS
+    size_t length() const { return keys.length(); }
+    bool empty()    const { return keys.empty();  }
+    void clear() {
+        keys.clear();
+        values.clear();
+    }
+    void reserve(int n) {
+        keys.reserve(n);
+        values.reserve(n);
+    }
+
+    void insert(const Key& key, const T& value);
+    T& at(const Key& key);
+    const T& at(const Key& key) const;
+    bool count(const Key& key) const { return matches(lowerBound(key), key); }
+    void erase(const Key& key);
+
+    Iterator find(const Key& key);
+    ConstIterator find(const Key& key) const;
+    Iterator lower_bound(const Key& key) { return begin() + lowerBound(key); }
+    ConstIterator lower_bound(const Key& key) const { return begin() + lowerBound(key); }
+
+    template <class... Args>
+    void emplace(const Key& key, Args&&... args);
+
+    // Adds a run of (key, value) pairs already sorted by key in one merge pass,
+    // O(length() + batch); a run that starts past the last key is appended
+    // without touching the existing entries. Keys already present, or repeated
+    // within the run, keep their first value, as with insert().
+    template <class InputIterator>
+    void insert_sorted(InputIterator first, InputIterator last);
+
+    // Same for pairs in any order: sorts the batch, then merges it.
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
+    // Moves every key of other into this map, keeping this map's value for
+    // keys present in both. other is left empty.
+    void merge(FlatMap&& other);
+
+    // OVERLOADED OPERATORS
+    T& operator[](const Key& key);
+    const T& operator[](const Key& key) const;
+
+    FlatMap& operator=(const FlatMap& other);       /* Copy Assignment Operator */
+    FlatMap& operator=(FlatMap&& other) noexcept;   /* Move Assignment Operator */
+
+    friend bool operator==(const FlatMap& lhs, const FlatMap& rhs) {
+        return lhs.keys == rhs.keys && lhs.values == rhs.values;
+    }
+    friend bool operator!=(const FlatMap& lhs, const FlatMap& rhs) { return !(lhs == rhs); }
+};
+
+// Index of the first key not less than key. The range [base, base + n]
+// always holds the answer and halves each step without a data-dependent branch.
+template <typename Key, typename T, typename Compare>
+size_t FlatMap<Key, T, Compare>::lowerBound(const Key& key) const {
+    size_t n = keys.length();
+    if(n == 0) return 0;
+
+    const Key* first = keys.data();
+    const Key* base = first;
+    while(n > 1) {
+        size_t half = n / 2;
+        base = compare(base[half], key) ? base + half : base;
+        n -= half;
+    }
+    return (base - first) + compare(*base, key);
+}
+
+template <typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::insertAt(size_t index, const Key& key, T&& value) {
+    size_t n = keys.length();
+    if(index == n) {
+        keys.push_back(key);
+        values.emplace_back(std::move(value));
+        return;
+    }
+
+    Key lastKey = std::move(keys.data()[n - 1]);         // the arrays may move when they grow
+    T lastValue = std::move(values.data()[n - 1]);
+    keys.emplace_back(std::move(lastKey));
+    values.emplace_back(std::move(lastValue));
+
+    Key* k = keys.data();
+    T* v = values.data();
+    std::move_backward(k + index, k + n - 1, k + n);
+    std::move_backward(v + index, v + n - 1, v + n);
+    k[index] = key;
+    v[index] = std::move(value);
+}
+
+template <typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::insert(const Key& key, const T& value) {
+    size_t index = lowerBound(key);
+    if(matches(index, key)) return;
+
+    insertAt(index, key, T(value));
+}
+
+template <typename Key, typename T, typename Compare>
+T& FlatMap<Key, T, Compare>::at(const Key& key) {
+    size_t index = lowerBound(key);
+    if(!matches(index, key)) {
+        std::cerr << "Key not available." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    return values.data()[index];
+}
+
+template <typename Key, typename T, typename Compare>
+const T& FlatMap<Key, T, Compare>::at(const Key& key) const {
+    size_t index = lowerBound(key);
+    if(!matches(index, key)) {
+        std::cerr << "Key not available." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    return values.data()[index];
+}
+
+template <typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::erase(const Key& key) {
+    size_t index = lowerBound(key);
+    if(!matches(index, key)) return;
+
+    Key* k = keys.data();
+    T* v = values.data();
+    size_t n = keys.length();
+    std::move(k + index + 1, k + n, k + index);
+    std::move(v + index + 1, v + n, v + index);
+    keys.pop_back();
+    values.pop_back();
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::Iterator FlatMap<Key, T, Compare>::find(const Key& key) {
+    size_t index = lowerBound(key);
+    return matches(index, key) ? begin() + index : end();
+}
+
+template <typename Key, typename T, typename Compare>
+typename FlatMap<Key, T, Compare>::ConstIterator FlatMap<Key, T, Compare>::find(const Key& key) const {
+    size_t index = lowerBound(key);
+    return matches(index, key) ? begin() + index : end();
+}
+
+template <typename Key, typename T, typename Compare>
+template <class... Args>
+void FlatMap<Key, T, Compare>::emplace(const Key& key, Args&&... args) {
+    size_t index = lowerBound(key);
+    T value(std::forward<Args>(args)...);               // direct-init, as in Vector::emplace_back
+    if(matches(index, key)) values.data()[index] = std::move(value);
+    else insertAt(index, key, std::move(value));
+}
+
+// batchKeys/batchValues are sorted and free of duplicates; both are consumed.
+template <typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::mergeSorted(Vector<Key>& batchKeys, Vector<T>& batchValues) {
+    size_t n = keys.length(), m = batchKeys.length();
+    if(m == 0) return;
+
+    Key* bk = batchKeys.data();
+    T* bv = batchValues.data();
+    if(n == 0 || compare(keys.data()[n - 1], bk[0])) {
+        reserve((int)(n + m));
+        for(size_t j = 0; j < m; j++) {
+            keys.emplace_back(std::move(bk[j]));
+            values.emplace_back(std::move(bv[j]));
+        }
+        return;
+    }
+
+    Vector<Key> mergedKeys;
+    Vector<T> mergedValues;
+    mergedKeys.reserve((int)(n + m));
+    mergedValues.reserve((int)(n + m));
+
+    Key* k = keys.data();
+    T* v = values.data();
+    size_t i = 0, j = 0;
+    while(i < n || j < m) {
+        if(j == m || (i < n && compare(k[i], bk[j]))) {
+            mergedKeys.emplace_back(std::move(k[i]));
+            mergedValues.emplace_back(std::move(v[i++]));
+        }
+        else if(i == n || compare(bk[j], k[i])) {
+            mergedKeys.emplace_back(std::move(bk[j]));
+            mergedValues.emplace_back(std::move(bv[j++]));
+        }
+        else {
+            j++;                                        // present in both: keep ours
+        }
+    }
+
+    keys = std::move(mergedKeys);
+    values = std::move(mergedValues);
+}
+
+template <typename Key, typename T, typename Compare>
+template <class InputIterator>
+void FlatMap<Key, T, Compare>::insert_sorted(InputIterator first, InputIterator last) {
+    Vector<Key> batchKeys;
+    Vector<T> batchValues;
+    for(; first != last; ++first) {
+        const auto& [key, value] = *first;
+        size_t m = batchKeys.length();
+        if(m > 0) {
+            const Key& previous = batchKeys.data()[m - 1];
+            if(compare(key, previous)) {
+                std::cerr << "FlatMap::insert_sorted needs keys in ascending order." << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+            if(!compare(previous, key)) continue;       // repeated key keeps its first value
+        }
+        batchKeys.push_back(key);
+        batchValues.push_back(value);
+    }
+
+    mergeSorted(batchKeys, batchValues);
+}
+
+template <typename Key, typename T, typename Compare>
+template <class InputIterator>
+void FlatMap<Key, T, Compare>::insert(InputIterator first, InputIterator last) {
+    Vector<std::pair<Key, T>> batch;
+    for(; first != last; ++first) {
+        const auto& [key, value] = *first;
+        batch.push_back(std::pair<Key, T>(key, value));
+    }
+
+    std::stable_sort(batch.begin(), batch.end(), [this](const std::pair<Key, T>& a, const std::pair<Key, T>& b) {
+        return compare(a.first, b.first);
+    });
+    insert_sorted(batch.begin(), batch.end());
+}
+
+template <typename Key, typename T, typename Compare>
+void FlatMap<Key, T, Compare>::merge(FlatMap&& other) {
+    if(this == &other) return;
+
+    mergeSorted(other.keys, other.values);
+    other.clear();
+}
+
+template <typename Key, typename T, typename Compare>
+T& FlatMap<Key, T, Compare>::operator[](const Key& key) {
+    size_t index = lowerBound(key);
+    if(!matches(index, key)) insertAt(index, key, T());
+
+    return values.data()[index];
+}
+
+template <typename Key, typename T, typename Compare>
+const T& FlatMap<Key, T, Compare>::operator[](const Key& key) const {
+    size_t index = lowerBound(key);
+    if(!matches(index, key)) {
+        std::cerr << "Key not found" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    return values.data()[index];
+}
+
+template <typename Key, typename T, typename Compare>
+FlatMap<Key, T, Compare>& FlatMap<Key, T, Compare>::operator=(const FlatMap& other) {
+    if(this != &other) {
+        keys = other.keys;
+        values = other.values;
+        compare = other.compare;
+    }
+
+    return *this;
+}
+
+template <typename Key, typename T, typename Compare>
+FlatMap<Key, T, Compare>& FlatMap<Key, T, Compare>::operator=(FlatMap&& other) noexcept {
+    if(this != &other) {
+        keys = std::move(other.keys);
+        values = std::move(other.values);
+        compare = std::move(other.compare);
+    }
+
+    return *this;
+}
@@ -1,8 +1,18 @@
+# pragma once
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
 template <typename Iter>
 class ReverseIterator {
 public:
     using iterator_type     = Iter;
     using iterator_category = typename std::iterator_traits<Iter>::iterator_category;
+#if __cplusplus >= 202002L
+    // Reversal keeps random access but never contiguity.
+    using iterator_concept  = std::conditional_t<std::random_access_iterator<Iter>,
+                                                 std::random_access_iterator_tag, std::bidirectional_iterator_tag>;
+#endif
     using value_type        = typename std::iterator_traits<Iter>::value_type;
     using difference_type   = typename std::iterator_traits<Iter>::difference_type;
     using pointer           = typename std::iterator_traits<Iter>::pointer;
@@ -31,6 +41,7 @@ public:
     ReverseIterator operator+(difference_type n) const { return ReverseIterator(current - n); }
     ReverseIterator operator-(difference_type n) const { return ReverseIterator(current + n); }
     difference_type operator-(const ReverseIterator& other) const { return other.current - current; }
+    friend ReverseIterator operator+(difference_type n, const ReverseIterator& it) { return it + n; }
 
     ReverseIterator& operator+=(difference_type n) { current -= n; return *this; }
     ReverseIterator& operator-=(difference_type n) { current += n; return *this; }
@@ -0,0 +1,316 @@
+# pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+#include "Vector.hpp"
+
+// FIXED-CAPACITY FIFO QUEUES
+// Three ring buffers over one contiguous Vector of slots, sized once at
+// construction to the next power of two so an index wraps with a mask:
+//
+//   RingBuffer<T>   single thread
+//   SPSCQueue<T>    one producer thread, one consumer thread, lock-free
+//   MPMCQueue<T>    any number of producers and consumers, lock-free
+//
+// push() and pop() never block and never allocate: they return false when the
+// queue is full or empty. Head and tail are free-running counters (only their
+// low bits pick a slot), so length() is tail - head and full and empty need no
+// spare slot. Popped slots keep a moved-from T until overwritten.
+
+static const size_t CACHE_LINE = 64;
+
+inline size_t ringCapacity(size_t n) {
+    size_t capacity = 1;
+    while(capacity < n) capacity <<= 1;
+    return capacity;
+}
+
+// Copies n values into the ring starting at counter position, in at most two runs.
+template <class T>
+void ringWrite(T* slots, size_t mask, size_t position, const T* values, size_t n) {
+    size_t start = position & mask;
+    size_t first = std::min(n, mask + 1 - start);
+    std::copy(values, values + first, slots + start);
+    std::copy(values + first, values + n, slots);
+}
+
+template <class T>
+void ringRead(T* slots, size_t mask, size_t position, T* out, size_t n) {
+    size_t start = position & mask;
+    size_t first = std::min(n, mask + 1 - start);
+    std::move(slots + start, slots + start + first, out);
+    std::move(slots, slots + (n - first), out + first);
+}
+
+template <class T>
+class RingBuffer {
+private:
+    Vector<T> slots;
+    size_t mask;
+    size_t head;                    // next position to pop
+    size_t tail;                    // next position to push
+
+public:
+    // CONSTRUCTORS
+
+    // 1. Constructor (capacity is rounded up to a power of two)
+    explicit RingBuffer(size_t capacity) : slots((int)ringCapacity(capacity)), mask(ringCapacity(capacity) - 1), head(0), tail(0) {}
+
+    // 2. Move Constructor
+    RingBuffer(RingBuffer&& other) noexcept
+        : slots(std::move(other.slots)), mask(other.mask), head(other.head), tail(other.tail) {
+        other.head = other.tail = 0;
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // MEMBER FUNCTIONS
+    size_t capacity() const { return mask + 1;               }
+    size_t length()   const { return tail - head;            }
+    bool empty()      const { return tail == head;           }
+    bool full()       const { return tail - head == mask + 1; }
+    T& front()              { return slots.data()[head & mask]; }
+    void clear()            { head = tail = 0;               }
+
+    bool push(const T& value) {
+        if(full()) return false;
+        slots.data()[tail++ & mask] = value;
+        return true;
+    }
+
+    bool push(T&& value) {
+        if(full()) return false;
+        slots.data()[tail++ & mask] = std::move(value);
+        return true;
+    }
+
+    bool pop(T& out) {
+        if(empty()) return false;
+        out = std::move(slots.data()[head++ & mask]);
+        return true;
+    }
+
+    // Pushes as many of values[0..n) as fit; returns how many.
+    size_t push_n(const T* values, size_t n) {
+        n = std::min(n, capacity() - length());
+        ringWrite(slots.data(), mask, tail, values, n);
+        tail += n;
+        return n;
+    }
+
+    // Pops up to n values into out; returns how many.
+    size_t pop_n(T* out, size_t n) {
+        n = std::min(n, length());
+        ringRead(slots.data(), mask, head, out, n);
+        head += n;
+        return n;
+    }
+};
+
+// Single producer, single consumer. Each side owns one index and keeps a
+// private copy of the other side's index, refreshed only when the ring looks
+// full (producer) or empty (consumer), so most operations touch no cache line
+// the other thread writes. The two sides sit on separate cache lines.
+template <class T>
+class SPSCQueue {
+private:
+    Vector<T> slots;
+    size_t mask;
+
+    alignas(CACHE_LINE) std::atomic<size_t> head;   // written by the consumer
+    size_t cachedTail;                              // consumer's last view of tail
+
+    alignas(CACHE_LINE) std::atomic<size_t> tail;   // written by the producer
+    size_t cachedHead;                              // producer's last view of head
+
+    // Free slots as far as the producer knows, refreshing once if short of wanted.
+    size_t space(size_t position, size_t wanted) {
+        size_t free = mask + 1 - (position - cachedHead);
+        if(free < wanted) {
+            cachedHead = head.load(std::memory_order_acquire);
+            free = mask + 1 - (position - cachedHead);
+        }
+        return free;
+    }
+
+    size_t available(size_t position, size_t wanted) {
+        size_t ready = cachedTail - position;
+        if(ready < wanted) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            ready = cachedTail - position;
+        }
+        return ready;
+    }
+
+public:
+    // CONSTRUCTORS
+
+    // 1. Constructor (capacity is rounded up to a power of two)
+    explicit SPSCQueue(size_t capacity)
+        : slots((int)ringCapacity(capacity)), mask(ringCapacity(capacity) - 1),
+          head(0), cachedTail(0), tail(0), cachedHead(0) {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // MEMBER FUNCTIONS
+    size_t capacity() const { return mask + 1; }
+    // Exact only when neither side is running.
+    size_t length() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+    bool empty() const { return length() == 0; }
+
+    // Producer side.
+    bool push(const T& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if(space(position, 1) == 0) return false;
+        slots.data()[position & mask] = value;
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(T&& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if(space(position, 1) == 0) return false;
+        slots.data()[position & mask] = std::move(value);
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Publishes the whole batch with one release store.
+    size_t push_n(const T* values, size_t n) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        n = std::min(n, space(position, n));
+        ringWrite(slots.data(), mask, position, values, n);
+        tail.store(position + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side.
+    bool pop(T& out) {
+        size_t position = head.load(std::memory_order_relaxed);
+        if(available(position, 1) == 0) return false;
+        out = std::move(slots.data()[position & mask]);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t pop_n(T* out, size_t n) {
+        size_t position = head.load(std::memory_order_relaxed);
+        n = std::min(n, available(position, n));
+        ringRead(slots.data(), mask, position, out, n);
+        head.store(position + n, std::memory_order_release);
+        return n;
+    }
+};
+
+// Bounded multi-producer, multi-consumer queue (Vyukov's design). Every slot
+// carries a sequence number telling whose turn it is: position p may be
+// written once sequence == p and read once sequence == p + 1. Producers and
+// consumers claim positions with a CAS on tail or head, then hand the slot
+// over with a release store of its sequence.
+template <class T>
+class MPMCQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+
+        Cell() : sequence(0) {}
+        // Vector copies cells while it is being built; never while the queue is in use.
+        Cell(const Cell& other) : sequence(other.sequence.load(std::memory_order_relaxed)), value(other.value) {}
+        Cell& operator=(const Cell& other) {
+            sequence.store(other.sequence.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            value = other.value;
+            return *this;
+        }
+    };
+
+    Vector<Cell> cells;
+    size_t mask;
+
+    alignas(CACHE_LINE) std::atomic<size_t> head;   // next position to pop
+    alignas(CACHE_LINE) std::atomic<size_t> tail;   // next position to push
+
+    // Claims the next position of counter whose cell is at turn offset, or
+    // returns nullptr when the ring is full (push) or empty (pop).
+    Cell* claim(std::atomic<size_t>& counter, size_t offset, size_t& position) {
+        position = counter.load(std::memory_order_relaxed);
+        while(true) {
+            Cell* cell = &cells.data()[position & mask];
+            intptr_t diff = (intptr_t)cell->sequence.load(std::memory_order_acquire) - (intptr_t)(position + offset);
+            if(diff == 0) {
+                if(counter.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) return cell;
+            }
+            else if(diff < 0) {
+                return nullptr;
+            }
+            else {
+                position = counter.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    // CONSTRUCTORS
+
+    // 1. Constructor (capacity is rounded up to a power of two)
+    explicit MPMCQueue(size_t capacity) : cells((int)ringCapacity(capacity)), mask(ringCapacity(capacity) - 1), head(0), tail(0) {
+        for(size_t i = 0; i <= mask; i++) {
+            cells.data()[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    // MEMBER FUNCTIONS
+    size_t capacity() const { return mask + 1; }
+    // Exact only when no thread is running.
+    size_t length() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+    bool empty() const { return length() == 0; }
+
+    bool push(const T& value) {
+        size_t position;
+        Cell* cell = claim(tail, 0, position);
+        if(!cell) return false;
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(T&& value) {
+        size_t position;
+        Cell* cell = claim(tail, 0, position);
+        if(!cell) return false;
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        size_t position;
+        Cell* cell = claim(head, 1, position);
+        if(!cell) return false;
+        out = std::move(cell->value);
+        cell->sequence.store(position + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Batches claim one slot at a time: slots ahead may still be held by a
+    // slower thread, so a contiguous range cannot be reserved in one step.
+    // Values of one batch may therefore interleave with other threads' values.
+    size_t push_n(const T* values, size_t n) {
+        size_t pushed = 0;
+        while(pushed < n && push(values[pushed])) pushed++;
+        return pushed;
+    }
+
+    size_t pop_n(T* out, size_t n) {
+        size_t popped = 0;
+        while(popped < n && pop(out[popped])) popped++;
+        return popped;
+    }
+};
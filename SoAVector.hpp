@@ -0,0 +1,306 @@
+# pragma once
+#include <iterator>
+#include <cstddef>
+#include <iostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "Vector.hpp"
+
+// Structure-of-arrays sequence: SoAVector<float, float, int> keeps one
+// Vector per field instead of a Vector of structs, so a scan over one field
+// reads only that field's bytes. Rows are read and written whole through
+// std::tuple<Fields&...> proxies (structured bindings work on them); column<I>()
+// and data<I>() hand out a single field as a plain contiguous array.
+//
+// All columns grow together: the SoAVector owns the capacity and reserves
+// every column at once, so push_back never reallocates one column alone.
+template <class... Fields>
+class SoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+    static_assert(!(std::is_same_v<Fields, bool> || ...),
+                  "Vector<bool> is bit-packed and has no bool* data(); store the flag as char");
+
+public:
+    typedef std::tuple<Fields...> value_type;
+    typedef std::tuple<Fields&...> reference;
+    typedef std::tuple<const Fields&...> const_reference;
+
+    template <size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+
+private:
+    std::tuple<Vector<Fields>...> columns;
+    size_t size;
+    size_t capacity;
+
+    // Makes room for one more row in every column.
+    void grow() {
+        if(size == capacity) reserve(capacity == 0 ? 1 : (int)(capacity * 2));
+    }
+
+    reference row(size_t i) {
+        return std::apply([i](Vector<Fields>&... column) { return reference(column.data()[i]...); }, columns);
+    }
+
+    const_reference row(size_t i) const {
+        return std::apply([i](const Vector<Fields>&... column) { return const_reference(column.data()[i]...); }, columns);
+    }
+
+    void checkIndex(int index) const {
+        if(index < 0 || index >= (int)size) {
+            std::cerr << "Index " << index << " out of bound." << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+public:
+    // CONSTRUCTORS
+
+    // 1. Default Constructor
+    SoAVector() : size(0), capacity(0) {}
+
+    // 2. Constructor: n copies of the given row
+    SoAVector(int n, const Fields&... values) : columns(Vector<Fields>(n, values)...), size(n), capacity(n) {}
+
+    // 3. Copy Constructor
+    SoAVector(const SoAVector& other) : size(other.size), capacity(other.capacity) {
+        columns = other.columns;
+    }
+
+    // 4. Move Constructor
+    SoAVector(SoAVector&& other) noexcept
+        : columns(std::move(other.columns)), size(other.size), capacity(other.capacity) {
+        other.size = 0;
+        other.capacity = 0;
+    }
+
+    // ITERATOR
+    // Random access over rows; dereferencing yields a reference tuple, so
+    // there is no operator-> and the iterator is not contiguous.
+    struct Iterator {
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = SoAVector::value_type;
+        using reference         = SoAVector::reference;
+
+        Iterator(SoAVector* owner = nullptr, difference_type index = 0) : owner(owner), index(index) {}
+
+        reference operator*() const { return owner->row(index); }
+        reference operator[](difference_type n) const { return owner->row(index + n); }
+
+        Iterator& operator++() { index++; return *this; }
+        Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
+        Iterator& operator--() { index--; return *this; }
+        Iterator operator--(int) { Iterator tmp = *this; --(*this); return tmp; }
+
+        Iterator operator+(difference_type n) const { return Iterator(owner, index + n); }
+        Iterator operator-(difference_type n) const { return Iterator(owner, index - n); }
+        difference_type operator-(const Iterator& other) const { return index - other.index; }
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+
+        Iterator& operator+=(difference_type n) { index += n; return *this; }
+        Iterator& operator-=(difference_type n) { index -= n; return *this; }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.index == b.index; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.index != b.index; }
+        friend bool operator< (const Iterator& a, const Iterator& b) { return a.index < b.index; }
+        friend bool operator> (const Iterator& a, const Iterator& b) { return a.index > b.index; }
+        friend bool operator<=(const Iterator& a, const Iterator& b) { return a.index <= b.index; }
+        friend bool operator>=(const Iterator& a, const Iterator& b) { return a.index >= b.index; }
+
+    private:
+        friend struct ConstIterator;
+        SoAVector* owner;
+        difference_type index;
+    };
+
+    struct ConstIterator {
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = SoAVector::value_type;
+        using reference         = SoAVector::const_reference;
+
+        ConstIterator(const SoAVector* owner = nullptr, difference_type index = 0) : owner(owner), index(index) {}
+        ConstIterator(const Iterator& it) : owner(it.owner), index(it.index) {}
+
+        reference operator*() const { return owner->row(index); }
+        reference operator[](difference_type n) const { return owner->row(index + n); }
+
+        ConstIterator& operator++() { index++; return *this; }
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
+        ConstIterator& operator--() { index--; return *this; }
+        ConstIterator operator--(int) { ConstIterator tmp = *this; --(*this); return tmp; }
+
+        ConstIterator operator+(difference_type n) const { return ConstIterator(owner, index + n); }
+        ConstIterator operator-(difference_type n) const { return ConstIterator(owner, index - n); }
+        difference_type operator-(const ConstIterator& other) const { return index - other.index; }
+        friend ConstIterator operator+(difference_type n, const ConstIterator& it) { return it + n; }
+
+        ConstIterator& operator+=(difference_type n) { index += n; return *this; }
+        ConstIterator& operator-=(difference_type n) { index -= n; return *this; }
+
+        friend bool operator==(const ConstIterator& a, const ConstIterator& b) { return a.index == b.index; }
+        friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return a.index != b.index; }
+        friend bool operator< (const ConstIterator& a, const ConstIterator& b) { return a.index < b.index; }
+        friend bool operator> (const ConstIterator& a, const ConstIterator& b) { return a.index > b.index; }
+        friend bool operator<=(const ConstIterator& a, const ConstIterator& b) { return a.index <= b.index; }
+        friend bool operator>=(const ConstIterator& a, const ConstIterator& b) { return a.index >= b.index; }
+
+    private:
+        const SoAVector* owner;
+        difference_type index;
+    };
+
+    Iterator begin() { return Iterator(this, 0); }
+    Iterator end()   { return Iterator(this, size); }
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end()   const { return ConstIterator(this, size); }
+    ConstIterator cbegin() const { return ConstIterator(this, 0); }
+    ConstIterator cend()   const { return ConstIterator(this, size); }
+
+    // MEMEBER FUNCTIONS
+    size_t length() const { return size;      }
+    bool empty()    const { return size == 0; }
+    reference front()             { return row(0);        }
+    reference back()              { return row(size - 1); }
+    const_reference front() const { return row(0);        }
+    const_reference back()  const { return row(size - 1); }
+
+    // One field as its own Vector. Changing its length directly would
+    // desynchronize the rows; use it for element access and scans.
+    template <size_t I> Vector<field_type<I>>& column() { return std::get<I>(columns); }
+    template <size_t I> const Vector<field_type<I>>& column() const { return std::get<I>(columns); }
+
+    // Contiguous array of length() values of field I.
+    template <size_t I> field_type<I>* data() { return std::get<I>(columns).data(); }
+    template <size_t I> const field_type<I>* data() const { return std::get<I>(columns).data(); }
+
+    // Field I of row index.
+    template <size_t I> field_type<I>& get(int index);
+    template <size_t I> const field_type<I>& get(int index) const;
+
+    void push_back(const Fields&... values);
+    void push_back(const value_type& record);
+    void emplace_back(Fields... values);
+    void pop_back();
+    void clear();
+    void resize(int n);
+    void reserve(int n);
+    void shrink_to_fit();
+
+    // OVELOADED OPERATORS
+    reference operator[](int index);
+    const_reference operator[](int index) const;
+
+    SoAVector& operator=(const SoAVector& other);       /* Copy Assignment Operator */
+    SoAVector& operator=(SoAVector&& other) noexcept;   /* Move Assignment Operator */
+
+    friend bool operator==(const SoAVector& lhs, const SoAVector& rhs) { return lhs.columns == rhs.columns; }
+    friend bool operator!=(const SoAVector& lhs, const SoAVector& rhs) { return !(lhs == rhs); }
+};
+
+template <class... Fields>
+template <size_t I>
+typename SoAVector<Fields...>::template field_type<I>& SoAVector<Fields...>::get(int index) {
+    checkIndex(index);
+    return data<I>()[index];
+}
+
+template <class... Fields>
+template <size_t I>
+const typename SoAVector<Fields...>::template field_type<I>& SoAVector<Fields...>::get(int index) const {
+    checkIndex(index);
+    return data<I>()[index];
+}
+
+template <class... Fields>
+void SoAVector<Fields...>::push_back(const Fields&... values) {
+    grow();
+    std::apply([&](Vector<Fields>&... column) { (column.push_back(values), ...); }, columns);
+    size++;
+}
+
+template <class... Fields>
+void SoAVector<Fields...>::push_back(const value_type& record) {
+    std::apply([this](const Fields&... values) { push_back(values...); }, record);
+}
+
+template <class... Fields>
+void SoAVector<Fields...>::emplace_back(Fields... values) {
+    grow();
+    std::apply([&](Vector<Fields>&... column) { (column.emplace_back(std::move(values)), ...); }, columns);
+    size++;
+}
+
+template <class... Fields>
+void SoAVector<Fields...>::pop_back() {
+    if(size == 0) return;
+
+    std::apply([](Vector<Fields>&... column) { (column.pop_back(), ...); }, columns);
+    size--;
+}
+
+template <class... Fields>
+void SoAVector<Fields...>::clear() {
+    std::apply([](Vector<Fields>&... column) { (column.clear(), ...); }, columns);
+    size = 0;
+}
+
+template <class... Fields>
+void SoAVector<Fields...>::resize(int n) {
+    reserve(n);
+    while((int)size > n) pop_back();
+    while((int)size < n) emplace_back(Fields()...);
+}
+
+template <class... Fields>
+void SoAVector<Fields...>::reserve(int n) {
+    if(n <= (int)capacity) return;
+
+    std::apply([n](Vector<Fields>&... column) { (column.reserve(n), ...); }, columns);
+    capacity = n;
+}
+
+template <class... Fields>
+void SoAVector<Fields...>::shrink_to_fit() {
+    std::apply([](Vector<Fields>&... column) { (column.shrink_to_fit(), ...); }, columns);
+    capacity = size;
+}
+
+template <class... Fields>
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::operator[](int index) {
+    checkIndex(index);
+    return row(index);
+}
+
+template <class... Fields>
+typename SoAVector<Fields...>::const_reference SoAVector<Fields...>::operator[](int index) const {
+    checkIndex(index);
+    return row(index);
+}
+
+template <class... Fields>
+SoAVector<Fields...>& SoAVector<Fields...>::operator=(const SoAVector& other) {
+    if(this != &other) {
+        columns = other.columns;
+        size = other.size;
+        capacity = other.capacity;
+    }
+
+    return *this;
+}
+
+template <class... Fields>
+SoAVector<Fields...>& SoAVector<Fields...>::operator=(SoAVector&& other) noexcept {
+    if(this != &other) {
+        columns = std::move(other.columns);
+        size = other.size;
+        capacity = other.capacity;
+
+        other.size = 0;
+        other.capacity = 0;
+    }
+
+    return *this;
+}
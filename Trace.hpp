@@ -0,0 +1,79 @@
+# pragma once
+#include <cstddef>
+
+// ALLOCATION AND COPY TRACING
+// Compiled in only with -DCHIMPSTL_TRACE. Every container then keeps its own
+// TraceCounters (see trace_counters()), mirrors each event into the process
+// wide counters (global_trace_counters()) and forwards it to the callback set
+// with set_trace_callback(). Without the macro the containers' hooks are
+// empty inline functions and nothing below is referenced.
+
+enum class TraceEvent {
+    Allocate,       // amount = bytes requested from the heap
+    Reallocate,     // amount = bytes carried over into a new buffer
+    Copy,           // amount = elements copied
+    Move,           // amount = elements moved
+    NodeCreate,     // amount = bytes of the new node
+    NodeFree        // amount = bytes of the freed node
+};
+
+#ifdef CHIMPSTL_TRACE
+#include <atomic>
+
+template <class Count>
+struct BasicTraceCounters {
+    Count allocations{0};
+    Count bytes{0};
+    Count reallocations{0};
+    Count copies{0};
+    Count moves{0};
+    Count nodesCreated{0};
+    Count nodesFreed{0};
+
+    void record(TraceEvent event, size_t amount) {
+        switch(event) {
+            case TraceEvent::Allocate:   allocations += 1; bytes += amount; break;
+            case TraceEvent::Reallocate: reallocations += 1; break;
+            case TraceEvent::Copy:       copies += amount; break;
+            case TraceEvent::Move:       moves += amount; break;
+            case TraceEvent::NodeCreate: nodesCreated += 1; allocations += 1; bytes += amount; break;
+            case TraceEvent::NodeFree:   nodesFreed += 1; break;
+        }
+    }
+};
+
+typedef BasicTraceCounters<size_t> TraceCounters;
+typedef void (*TraceCallback)(TraceEvent event, const void* container, size_t amount);
+
+inline BasicTraceCounters<std::atomic<size_t>>& globalTrace() {
+    static BasicTraceCounters<std::atomic<size_t>> counters;
+    return counters;
+}
+
+inline std::atomic<TraceCallback>& traceCallback() {
+    static std::atomic<TraceCallback> callback{nullptr};
+    return callback;
+}
+
+// Installs a function called on every event of every container; nullptr removes it.
+inline void set_trace_callback(TraceCallback callback) { traceCallback() = callback; }
+
+inline TraceCounters global_trace_counters() {
+    auto& g = globalTrace();
+    TraceCounters result;
+    result.allocations = g.allocations;
+    result.bytes = g.bytes;
+    result.reallocations = g.reallocations;
+    result.copies = g.copies;
+    result.moves = g.moves;
+    result.nodesCreated = g.nodesCreated;
+    result.nodesFreed = g.nodesFreed;
+    return result;
+}
+
+inline void recordTrace(TraceCounters& instance, TraceEvent event, const void* container, size_t amount) {
+    instance.record(event, amount);
+    globalTrace().record(event, amount);
+    if(TraceCallback callback = traceCallback()) callback(event, container, amount);
+}
+#endif
@@ -1,11 +1,19 @@
 # pragma once
 #include <string>
+#include <string_view>
+#include <algorithm>
+#include "Vector.hpp"
+#include "Trace.hpp"
 
 struct TrieNode {
     TrieNode* children[26];
     bool isEndOfWord;
+    int id;                 // insertion index of the word ending here, -1 if none
+    int state;              // automaton state assigned by Trie::build()
+    Vector<int> top;        // best word ids of this subtree, highest weight first
+    bool cached;            // whether top is up to date
 
-    TrieNode() : isEndOfWord(false) {
+    TrieNode() : isEndOfWord(false), id(-1), state(0), cached(false) {
         for (int i = 0; i < 26; ++i) {
             children[i] = nullptr;
         }
@@ -15,24 +23,401 @@ struct TrieNode {
 class Trie {
 private:
     TrieNode* root;
+    int wordCount;
+    int cacheSize;                  // completions cached per node for top_k()
+    std::string text;               // every word back to back, one buffer for the whole trie
+    Vector<size_t> wordEnds;        // indexed by word id: end of the word in text
+    Vector<long long> weights;
+
+    // AHO-CORASICK AUTOMATON
+    // Flattened by build() in BFS order: row s of transitions holds the 26 goto
+    // targets of state s with failure links already folded in, so scanning costs
+    // one table lookup per byte. match[s] is the nearest state on s's failure
+    // chain (s included) that ends a word, -1 if none; state 0 is the root.
+    Vector<int> transitions;
+    Vector<int> fail;
+    Vector<int> match;
+    Vector<int> ids;
+    bool dirty;
+
+    int scanState;
+    size_t scanOffset;
+
+#ifdef CHIMPSTL_TRACE
+    mutable TraceCounters traceCounters;
+    void trace(TraceEvent event, size_t amount) const { recordTrace(traceCounters, event, this, amount); }
+#else
+    void trace(TraceEvent, size_t) const {}
+#endif
+
+    TrieNode* createNode() {
+        trace(TraceEvent::NodeCreate, sizeof(TrieNode));
+        return new TrieNode();
+    }
 public:
-    Trie() {   
-        root = new TrieNode();
+    explicit Trie(int cacheSize = 10) : cacheSize(cacheSize) {
+        if (cacheSize <= 0) {
+            std::cerr << "Trie cache size must be positive, got " << cacheSize << "." << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        root = createNode();
+        wordCount = 0;
+        dirty = true;
+        scanState = 0;
+        scanOffset = 0;
     }   
+    Trie(const Trie&) = delete;
+    Trie& operator=(const Trie&) = delete;
     ~Trie() {
-        // Destructor to free memory can be implemented here
+        clear(root);
     }   
 
-    void insert(const std::string& word) {
+    // Returns the word's id, reported by scan() for each of its occurrences.
+    // The weight ranks the word in top_k(); inserting an existing word keeps
+    // its current weight (see set_weight).
+    int insert(std::string_view word, long long weight = 0) {
         TrieNode* node = root;
         for (char ch : word) {
             int index = ch - 'a';
             if (!node->children[index]) {
-                node->children[index] = new TrieNode();
+                node->children[index] = createNode();
             }
             node = node->children[index];
         }
+        if (node->isEndOfWord) return node->id;
+
         node->isEndOfWord = true;
+        node->id = wordCount++;
+        addWord(word, weight);
+        dirty = true;
+
+        TrieNode* current = root;
+        for (size_t i = 0; ; i++) {
+            if (current->cached) offer(current->top, node->id);
+            if (i == word.size()) break;
+            current = current->children[word[i] - 'a'];
+        }
+        return node->id;
     }   
 
+    // Changes the weight of an inserted word, returns false if it is absent.
+    // Cached rankings on the word's path are patched in place; a node is only
+    // invalidated (and lazily rebuilt from its children) when a word in its
+    // full cache loses weight, since something uncached may now outrank it.
+    bool set_weight(const std::string& word, long long weight) {
+        TrieNode* node = walk(word);
+        if (!node || !node->isEndOfWord) return false;
+
+        int id = node->id;
+        bool lowered = weight < weights[id];
+        weights[id] = weight;
+
+        TrieNode* current = root;
+        for (size_t i = 0; ; i++) {
+            if (current->cached) reorder(current, id, lowered);
+            if (i == word.size()) break;
+            current = current->children[word[i] - 'a'];
+        }
+        return true;
+    }
+
+    // Moves every word of other into this trie; words already present keep
+    // their id and weight. Subtrees missing here are relinked rather than
+    // re-inserted, and the adopted words get ids after the existing ones.
+    // other is left empty.
+    void merge(Trie&& other) {
+        if (this == &other) return;
+        mergeNode(root, other.root, other);
+
+        clear(other.root);
+        other.root = other.createNode();
+        other.wordCount = 0;
+        other.text.clear();
+        other.wordEnds.clear();
+        other.weights.clear();
+        other.dirty = true;
+        dirty = true;
+    }
+
+#ifdef CHIMPSTL_TRACE
+    const TraceCounters& trace_counters() const { return traceCounters; }
+#endif
+
+    bool contains(const std::string& word) const {
+        TrieNode* node = walk(word);
+        return node && node->isEndOfWord;
+    }
+
+    bool starts_with(const std::string& prefix) const {
+        return walk(prefix) != nullptr;
+    }
+
+    // The k highest-weight words starting with prefix, best first (ties in
+    // lexicographic order). For k up to the cache size this reads the cached
+    // ranking of the prefix node: O(|prefix| + k) once warm. Larger k falls
+    // back to a walk of the whole subtree.
+    Vector<std::pair<std::string, long long>> top_k(const std::string& prefix, int k) const {
+        Vector<std::pair<std::string, long long>> result;
+        TrieNode* node = walk(prefix);
+        if (!node || k <= 0) return result;
+
+        if (k <= cacheSize) {
+            const Vector<int>& top = ranking(node);
+            for (int i = 0; i < k && i < (int)top.length(); i++) {
+                result.push_back({std::string(word(top[i])), weights[top[i]]});
+            }
+            return result;
+        }
+
+        Vector<int> all;
+        Vector<TrieNode*> stack;
+        stack.push_back(node);
+        while (!stack.empty()) {
+            TrieNode* current = stack.back();
+            stack.pop_back();
+            if (current->isEndOfWord) all.push_back(current->id);
+            for (int c = 0; c < 26; c++) {
+                if (current->children[c]) stack.push_back(current->children[c]);
+            }
+        }
+
+        int count = std::min(k, (int)all.length());
+        std::partial_sort(all.data(), all.data() + count, all.data() + all.length(),
+                          [this](int a, int b) { return better(a, b); });
+        for (int i = 0; i < count; i++) {
+            result.push_back({std::string(word(all[i])), weights[all[i]]});
+        }
+        return result;
+    }
+
+    // Compiles the trie into the flat automaton. scan() calls it when words were
+    // inserted since the last build; doing so resets the stream position.
+    void build() {
+        Vector<TrieNode*> order;
+        order.push_back(root);
+        for (size_t head = 0; head < order.length(); head++) {
+            TrieNode* node = order[head];
+            node->state = head;
+            for (int c = 0; c < 26; c++) {
+                if (node->children[c]) order.push_back(node->children[c]);
+            }
+        }
+
+        int states = order.length();
+        transitions.assign(states * 26, 0);
+        fail.assign(states, 0);
+        match.assign(states, -1);
+        ids.assign(states, -1);
+
+        for (int s = 0; s < states; s++) {
+            TrieNode* node = order[s];
+            ids[s] = node->id;
+            if (s > 0) match[s] = node->isEndOfWord ? s : match[fail[s]];
+
+            for (int c = 0; c < 26; c++) {
+                int fallback = s == 0 ? 0 : transitions[fail[s] * 26 + c];
+                if (node->children[c]) {
+                    int t = node->children[c]->state;
+                    transitions[s * 26 + c] = t;
+                    fail[t] = fallback;
+                }
+                else {
+                    transitions[s * 26 + c] = fallback;
+                }
+            }
+        }
+
+        dirty = false;
+        reset_scan();
+    }
+
+    // Feeds the next chunk of a stream through the automaton and calls
+    // callback(id, end) for every word occurrence, end being the stream offset
+    // just past its last character. Matches spanning chunk boundaries are found
+    // because the automaton state is kept between calls. Bytes outside 'a'-'z'
+    // act as separators.
+    template <class Callback>
+    void scan(std::string_view chunk, Callback callback) {
+        if (dirty) build();
+
+        const int* next = transitions.data();
+        const int* failure = fail.data();
+        const int* output = match.data();
+        const int* wordIds = ids.data();
+
+        int state = scanState;
+        for (size_t i = 0; i < chunk.size(); i++) {
+            unsigned c = (unsigned char)chunk[i] - 'a';
+            state = c < 26 ? next[state * 26 + c] : 0;
+            for (int s = output[state]; s > 0; s = output[failure[s]]) {
+                callback(wordIds[s], scanOffset + i + 1);
+            }
+        }
+
+        scanState = state;
+        scanOffset += chunk.size();
+    }
+
+    // Starts a new stream.
+    void reset_scan() {
+        scanState = 0;
+        scanOffset = 0;
+    }
+
+    // Words within max_distance edits (Levenshtein) of query, paired with their
+    // distance, in lexicographic order. Subtrees whose DP row minimum exceeds
+    // the bound are never entered.
+    Vector<std::pair<std::string, int>> fuzzy_find(const std::string& query, int max_distance) const {
+        Vector<std::pair<std::string, int>> matches;
+        Vector<int> rows((int)query.size() + 1);           // one DP row per depth, grown as the walk descends
+        for (int i = 0; i <= (int)query.size(); i++) {
+            rows[i] = i;
+        }
+
+        std::string prefix;
+        fuzzySearch(root, rows, query, prefix, max_distance, matches);
+        return matches;
+    }
+
+private:
+    TrieNode* walk(const std::string& prefix) const {
+        TrieNode* node = root;
+        for (char ch : prefix) {
+            unsigned index = (unsigned char)ch - 'a';
+            if (index >= 26 || !node->children[index]) return nullptr;
+            node = node->children[index];
+        }
+        return node;
+    }
+
+    bool better(int a, int b) const {
+        if (weights[a] != weights[b]) return weights[a] > weights[b];
+        return word(a) < word(b);
+    }
+
+    std::string_view word(int id) const {
+        size_t begin = id == 0 ? 0 : wordEnds[id - 1];
+        return std::string_view(text).substr(begin, wordEnds[id] - begin);
+    }
+
+    void addWord(std::string_view word, long long weight) {
+        text.append(word);
+        wordEnds.push_back(text.size());
+        weights.push_back(weight);
+    }
+
+    // Adds id to a ranking if it makes the cut, keeping it sorted and capped.
+    void offer(Vector<int>& top, int id) const {
+        if ((int)top.length() < cacheSize) top.push_back(id);
+        else if (better(id, top.back())) top[top.length() - 1] = id;
+        else return;
+
+        for (int i = top.length() - 1; i > 0 && better(top[i], top[i-1]); i--) {
+            std::swap(top[i], top[i-1]);
+        }
+    }
+
+    // Moves id to its new place in a cached ranking after its weight changed.
+    void reorder(TrieNode* node, int id, bool lowered) const {
+        Vector<int>& top = node->top;
+        int pos = 0;
+        while (pos < (int)top.length() && top[pos] != id) pos++;
+
+        if (pos == (int)top.length()) {
+            offer(top, id);
+        }
+        else if (lowered && (int)top.length() == cacheSize) {
+            node->cached = false;
+        }
+        else {
+            for (; pos > 0 && better(top[pos], top[pos-1]); pos--) std::swap(top[pos], top[pos-1]);
+            for (; pos + 1 < (int)top.length() && better(top[pos+1], top[pos]); pos++) std::swap(top[pos], top[pos+1]);
+        }
+    }
+
+    // Cached ranking of a subtree, rebuilt from the children's rankings when stale.
+    const Vector<int>& ranking(TrieNode* node) const {
+        if (node->cached) return node->top;
+
+        node->top.clear();
+        if (node->isEndOfWord) offer(node->top, node->id);
+        for (int c = 0; c < 26; c++) {
+            if (!node->children[c]) continue;
+            const Vector<int>& sub = ranking(node->children[c]);
+            for (size_t i = 0; i < sub.length(); i++) {
+                offer(node->top, sub[i]);
+            }
+        }
+        node->cached = true;
+        return node->top;
+    }
+
+    void mergeNode(TrieNode* into, TrieNode* from, Trie& other) {
+        into->cached = false;
+        if (from->isEndOfWord && !into->isEndOfWord) adoptWord(into, from->id, other);
+
+        for (int c = 0; c < 26; c++) {
+            TrieNode* source = from->children[c];
+            if (!source) continue;
+
+            if (!into->children[c]) {
+                into->children[c] = source;
+                from->children[c] = nullptr;
+                adopt(source, other);
+            }
+            else {
+                mergeNode(into->children[c], source, other);
+            }
+        }
+    }
+
+    void adopt(TrieNode* node, Trie& other) {
+        node->cached = false;
+        if (node->isEndOfWord) adoptWord(node, node->id, other);
+        for (int c = 0; c < 26; c++) {
+            if (node->children[c]) adopt(node->children[c], other);
+        }
+    }
+
+    void adoptWord(TrieNode* node, int otherId, Trie& other) {
+        node->isEndOfWord = true;
+        node->id = wordCount++;
+        addWord(other.word(otherId), other.weights[otherId]);
+    }
+
+    void clear(TrieNode* node) {
+        if (!node) return;
+        for (int i = 0; i < 26; i++) clear(node->children[i]);
+        trace(TraceEvent::NodeFree, sizeof(TrieNode));
+        delete node;
+    }
+
+    void fuzzySearch(TrieNode* node, Vector<int>& rows, const std::string& query, std::string& prefix,
+                     int maxDistance, Vector<std::pair<std::string, int>>& matches) const {
+        int n = query.size();
+        size_t depth = prefix.size();
+        if (node->isEndOfWord && rows.data()[depth * (n + 1) + n] <= maxDistance) {
+            matches.push_back({prefix, rows.data()[depth * (n + 1) + n]});
+        }
+        if (rows.length() < (depth + 2) * (n + 1)) rows.resize((int)((depth + 2) * (n + 1)));
+
+        for (int c = 0; c < 26; c++) {
+            if (!node->children[c]) continue;
+
+            const int* row = rows.data() + depth * (n + 1);      // re-read: deeper calls may grow rows
+            int* next = rows.data() + (depth + 1) * (n + 1);
+            next[0] = row[0] + 1;
+            int best = next[0];
+            for (int i = 1; i <= n; i++) {
+                int substitute = row[i-1] + (query[i-1] != 'a' + c);
+                next[i] = std::min({next[i-1] + 1, row[i] + 1, substitute});
+                best = std::min(best, next[i]);
+            }
+            if (best > maxDistance) continue;
+
+            prefix.push_back('a' + c);
+            fuzzySearch(node->children[c], rows, query, prefix, maxDistance, matches);
+            prefix.pop_back();
+        }
+    }
 };
\ No newline at end of file
@@ -1,10 +1,16 @@
 # pragma once
 #include <iterator>
 #include <cstddef> 
+#include <iostream>
 #include <memory>
 #include <utility>
 #include <algorithm>
 #include "ReverseIterator.hpp"
+#include "Trace.hpp"
+#ifdef CHIMPSTL_STATS
+#include <string>
+#include <sstream>
+#endif
 
 template <class T>
 class Vector {
@@ -13,6 +19,33 @@ private:
     size_t size;
     size_t capacity;
 
+#ifdef CHIMPSTL_STATS
+    size_t reallocations = 0;
+    size_t bytesMoved = 0;
+#endif
+
+#ifdef CHIMPSTL_TRACE
+    mutable TraceCounters traceCounters;
+    void trace(TraceEvent event, size_t amount) const { recordTrace(traceCounters, event, this, amount); }
+#else
+    void trace(TraceEvent, size_t) const {}
+#endif
+
+    T* allocate(size_t n) {
+        trace(TraceEvent::Allocate, n * sizeof(T));
+        return new T[n];
+    }
+
+    // Called whenever the buffer is replaced; moved = elements copied across.
+    void recordRealloc(size_t moved) {
+#ifdef CHIMPSTL_STATS
+        reallocations++;
+        bytesMoved += moved * sizeof(T);
+#endif
+        trace(TraceEvent::Reallocate, moved * sizeof(T));
+        trace(TraceEvent::Copy, moved);
+    }
+
 public:
     // CONSTRUCTORS
     
@@ -21,7 +54,7 @@ public:
 
     // 2. Constructor
     Vector(int n, const T& elem = T()) : size(n), capacity(n) {
-        array = new T[capacity];
+        array = allocate(capacity);
         for(int i = 0; i < (int)size; i++) {
             array[i] = elem;
         }
@@ -32,18 +65,20 @@ public:
         size = other.size;
         capacity = other.capacity;
 
-        array = new T[capacity];
+        array = allocate(capacity);
         for(int i = 0; i < (int)size; i++) {
             array[i] = other[i];
         }
+        trace(TraceEvent::Copy, size);
     }
 
     // 4. Brace-enclosed initialized list Constructor
     Vector(std::initializer_list<T> init) {
         size = init.size();
         capacity = size;
-        array = new T[capacity];
+        array = allocate(capacity);
         std::copy(init.begin(), init.end(), array);
+        trace(TraceEvent::Copy, size);
     }
 
     // 5. Move Constructor
@@ -60,15 +95,19 @@ public:
     // ITERATOR
     struct Iterator {
         using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+        using iterator_concept  = std::contiguous_iterator_tag;
+#endif
         using difference_type   = std::ptrdiff_t;
         using value_type        = T;
         using pointer           = T*;
         using reference         = T&;
 
-        Iterator(pointer ptr) : v_ptr(ptr) {}
+        Iterator(pointer ptr = nullptr) : v_ptr(ptr) {}
 
         reference operator*() const { return *v_ptr; }
-        pointer operator->() { return v_ptr; }
+        pointer operator->() const { return v_ptr; }
+        reference operator[](difference_type n) const { return v_ptr[n]; }
 
         Iterator& operator++() { v_ptr++; return *this; }
         Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
@@ -78,9 +117,10 @@ public:
         Iterator operator+(difference_type n) const { return Iterator(v_ptr + n); }
         Iterator operator-(difference_type n) const { return Iterator(v_ptr - n); }
         difference_type operator-(const Iterator& other) const { return v_ptr - other.v_ptr; }
+        friend Iterator operator+(difference_type n, const Iterator& it) { return Iterator(it.v_ptr + n); }
 
-        Iterator operator+=(difference_type n) const { v_ptr += n; return *this; }
-        Iterator operator-=(difference_type n) const { v_ptr -= n; return *this; }
+        Iterator& operator+=(difference_type n) { v_ptr += n; return *this; }
+        Iterator& operator-=(difference_type n) { v_ptr -= n; return *this; }
 
         friend bool operator==(const Iterator& a, const Iterator& b) { return a.v_ptr == b.v_ptr; };
         friend bool operator!=(const Iterator& a, const Iterator& b) { return a.v_ptr != b.v_ptr; };
@@ -95,15 +135,20 @@ public:
 
     struct ConstIterator {
         using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+        using iterator_concept  = std::contiguous_iterator_tag;
+#endif
         using difference_type   = std::ptrdiff_t;
         using value_type        = T;
         using pointer           = const T*;
         using reference         = const T&;
 
-        ConstIterator(pointer ptr) : v_ptr(ptr) {}
+        ConstIterator(pointer ptr = nullptr) : v_ptr(ptr) {}
+        ConstIterator(const Iterator& it) : v_ptr(it.operator->()) {}
 
         reference operator*() const { return *v_ptr; }
         pointer operator->() const { return v_ptr; }
+        reference operator[](difference_type n) const { return v_ptr[n]; }
 
         ConstIterator& operator++() { v_ptr++; return *this; }
         ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
@@ -113,9 +158,10 @@ public:
         ConstIterator operator+(difference_type n) const { return ConstIterator(v_ptr + n); }
         ConstIterator operator-(difference_type n) const { return ConstIterator(v_ptr - n); }
         difference_type operator-(const ConstIterator& other) const { return v_ptr - other.v_ptr; }
+        friend ConstIterator operator+(difference_type n, const ConstIterator& it) { return ConstIterator(it.v_ptr + n); }
 
-        ConstIterator operator+=(difference_type n) { v_ptr += n; return *this; }
-        ConstIterator operator-=(difference_type n) { v_ptr -= n; return *this; }
+        ConstIterator& operator+=(difference_type n) { v_ptr += n; return *this; }
+        ConstIterator& operator-=(difference_type n) { v_ptr -= n; return *this; }
 
         friend bool operator==(const ConstIterator& a, const ConstIterator& b) { return a.v_ptr == b.v_ptr; };
         friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return a.v_ptr != b.v_ptr; };
@@ -143,6 +189,9 @@ public:
     ReverseIterator<ConstIterator> rcend() const { return ReverseIterator<ConstIterator>(begin()); }
 
     // MEMEBER FUNCTIONS
+#ifdef CHIMPSTL_TRACE
+    const TraceCounters& trace_counters() const { return traceCounters; }
+#endif
 
     size_t length() const { return size;      }
     bool empty()    const { return size == 0; }
@@ -172,6 +221,38 @@ public:
     template <class... Args>
     void emplace_back(Args&&... args);
 
+#ifdef CHIMPSTL_STATS
+    // STATISTICS (compiled only with -DCHIMPSTL_STATS)
+    struct Stats {
+        size_t size;
+        size_t capacity;
+        size_t bytes;                     // heap bytes held by the buffer
+        double capacityRatio;             // capacity / size, 0 when empty
+        size_t reallocations;             // buffer replacements since construction
+        size_t bytesMoved;                // bytes copied across those replacements
+
+        std::string toText() const {
+            std::ostringstream out;
+            out << "size: " << size << "\ncapacity: " << capacity << "\nbytes: " << bytes
+                << "\ncapacity/size: " << capacityRatio << "\nreallocations: " << reallocations
+                << "\nbytes moved: " << bytesMoved << "\n";
+            return out.str();
+        }
+
+        std::string toJSON() const {
+            std::ostringstream out;
+            out << "{\"size\":" << size << ",\"capacity\":" << capacity << ",\"bytes\":" << bytes
+                << ",\"capacityRatio\":" << capacityRatio << ",\"reallocations\":" << reallocations
+                << ",\"bytesMoved\":" << bytesMoved << "}";
+            return out.str();
+        }
+    };
+
+    Stats stats() const {
+        return { size, capacity, capacity * sizeof(T), size ? (double)capacity / size : 0.0, reallocations, bytesMoved };
+    }
+#endif
+
     // OVELOADED OPERATORS
     T& operator[](int index);
     const T& operator[](int index) const;
@@ -188,10 +269,7 @@ public:
 
     // Destructors
     ~Vector() {
-        for(int i = 0; i < (int)size; i++){
-            array[i].~T();
-        }
-        delete[] array;
+        delete[] array;                                  // destroys every slot exactly once
         size = 0;
         capacity = 0;
     }
@@ -201,31 +279,33 @@ template <class T>
 void Vector<T>::push_back(const T& elem) {
     if(size == capacity) {
         capacity = (capacity == 0 ? 1 : capacity * 2);
-        T* newArray = new T[capacity];
+        T* newArray = allocate(capacity);
 
         for(size_t i = 0; i < size; i++) {
             newArray[i] = array[i];
         }
+        recordRealloc(size);
 
         delete[] array;
         array = newArray;
     }
 
     array[size++] = elem;
+    trace(TraceEvent::Copy, 1);
 }
 
 template <class T>
 void Vector<T>::pop_back() {
     if(size == 0) return;
 
-    array[size-1].~T();
+    array[size-1] = T();                                 // slots stay alive until delete[], reset instead
     size--;
 }
 
 template <class T>
 void Vector<T>::clear() {
     for(int i = 0; i < (int)size; i++) {
-        array[i].~T();
+        array[i] = T();
     }
     size = 0;
 }
@@ -239,13 +319,13 @@ template <class T>
 void Vector<T>::resize(int n, const T& value) {
     if(n < (int)capacity) {
         if(n < (int)size) {
-            while(size > n) {
-                array[size-1].~T();
+            while((int)size > n) {
+                array[size-1] = T();
                 size--;
             }
         }
         else {
-            while(size < n) {
+            while((int)size < n) {
                 array[size] = value;
                 size++;
             }
@@ -253,15 +333,17 @@ void Vector<T>::resize(int n, const T& value) {
     }
     else {
         capacity = n;
-        T* newArray = new T[capacity];
+        T* newArray = allocate(capacity);
 
         for(size_t i = 0; i < capacity; i++) {
             if(i < size) newArray[i] = array[i];
             else newArray[i] = value;
         }
+        recordRealloc(size);
 
         delete[] array;
         array = newArray;
+        size = n;
     }
 }
 
@@ -272,11 +354,12 @@ void Vector<T>::reserve(int n) {
     }
     else {
         capacity = n;
-        T* newArray = new T[capacity];
+        T* newArray = allocate(capacity);
 
         for(size_t i = 0; i < size; i++) {
             newArray[i] = array[i];
         }
+        recordRealloc(size);
 
         delete[] array;
         array = newArray;
@@ -287,11 +370,12 @@ template <class T>
 void Vector<T>::shrink_to_fit() {
     if(capacity == size) return;
     capacity = size;
-    T* newArray = new T[capacity];
+    T* newArray = allocate(capacity);
 
     for(size_t i = 0; i < size; i++) {
         newArray[i] = array[i];
     }
+    recordRealloc(size);
 
     delete[] array;
     array = newArray;
@@ -304,12 +388,14 @@ void Vector<T>::insert(const Iterator& iter, const T& val) {
 
 template <class T>
 void Vector<T>::insert(const Iterator& iter, int count, const T& val) {
-    if(iter - begin() >= size) {
+    if((size_t)(iter - begin()) >= size) {
         std::cerr << "Index out of range." << std::endl;
         std::exit(EXIT_FAILURE);
     }
 
+    trace(TraceEvent::Copy, count);
     if(capacity >= size + count) {
+        trace(TraceEvent::Copy, end() - iter);
         Iterator rit = end() + count - 1;
         while((int)(rit - iter) >= count) {
             *rit = *(rit - count);
@@ -322,7 +408,7 @@ void Vector<T>::insert(const Iterator& iter, int count, const T& val) {
     }
     else {
         capacity *= 2;
-        T* newArray = new T[capacity];
+        T* newArray = allocate(capacity);
 
         Iterator it = begin();
         while(it != iter) {
@@ -336,6 +422,7 @@ void Vector<T>::insert(const Iterator& iter, int count, const T& val) {
             *(newArray + count + (int)(it - begin())) = *it;
             it++;
         }
+        recordRealloc(size);
 
         delete[] array;
         array = newArray;
@@ -351,6 +438,7 @@ void Vector<T>::erase(const Iterator& iter) {
         std::cerr << "Unknown memory access" << std::endl;
         std::exit(EXIT_FAILURE);
     }
+    trace(TraceEvent::Copy, end() - it - 1);
     while(it + 1 != end()) {
         *(it) = *(it + 1);
         it++;
@@ -368,6 +456,7 @@ void Vector<T>::erase(const Iterator& first, const Iterator& last) {
     }
     Iterator next_it = it + 1;
     while(next_it != end() && next_it != last) next_it++;
+    trace(TraceEvent::Copy, end() - next_it);
     while(next_it != end()) {
         *(it) = *(next_it);
         it++;
@@ -378,9 +467,10 @@ void Vector<T>::erase(const Iterator& first, const Iterator& last) {
 
 template <class T>
 void Vector<T>::assign(int count, const T& val) {
-    if(capacity < count) {
+    if((int)capacity < count) {
         capacity = count;
-        T* newArray = new T[capacity];
+        T* newArray = allocate(capacity);
+        recordRealloc(0);
         delete[] array;
         array = newArray;
     }
@@ -397,7 +487,8 @@ void Vector<T>::assign(InputIterator first, InputIterator last) {
     int count = last - first;
     if(capacity < count) {
         capacity = count;
-        T* newArray = new T[capacity];
+        T* newArray = allocate(capacity);
+        recordRealloc(0);
         delete[] array;
         array = newArray;
     }
@@ -420,23 +511,26 @@ template <class... Args>
 void Vector<T>::emplace_back(Args&&... args) {
     if(size == capacity) {
         capacity = (capacity == 0 ? 1 : capacity * 2);
-        T* newArray = new T[capacity];
+        T* newArray = allocate(capacity);
 
         for(size_t i = 0; i < size; i++) {
             newArray[i] = array[i];
         }
+        recordRealloc(size);
 
         delete[] array;
         array = newArray;
     }
 
-    new (array + size) T(std::forward<Args>(args)...);   // placement new 
+    T value(std::forward<Args>(args)...);                // direct-init: no cast for a single argument
+    array[size] = std::move(value);                      // slot already constructed by new[]
+    trace(TraceEvent::Move, 1);
     size++;
 }
 
 template <class T>
 T& Vector<T>::operator[](int index) {
-    if(index >= size) {
+    if((size_t)index >= size) {
         std::cerr << "Index " << index << " out of bound." << std::endl;
         std::exit(EXIT_FAILURE);
     }
@@ -446,7 +540,7 @@ T& Vector<T>::operator[](int index) {
 
 template <class T>
 const T& Vector<T>::operator[](int index) const {
-    if(index >= size) {
+    if((size_t)index >= size) {
         std::cerr << "Index " << index << " out of bound." << std::endl;
         std::exit(EXIT_FAILURE);
     }
@@ -461,11 +555,12 @@ Vector<T>& Vector<T>::operator=(const Vector<T>& other) {
 
         size = other.size;
         capacity = other.capacity;
-        array = new T[capacity];
+        array = allocate(capacity);
 
         for(int i = 0; i < (int)size; i++) {
             array[i] = other[i];
         }
+        trace(TraceEvent::Copy, size);
     }
     
     return *this;
@@ -516,4 +611,5 @@ bool operator>(const Vector<T>& lhs, const Vector<T>& rhs) {
 template <class T>
 bool operator>=(const Vector<T>& lhs, const Vector<T>& rhs) {
     return !(lhs < rhs);
-}   
\ No newline at end of file
+}   
+#include "VectorBool.hpp"
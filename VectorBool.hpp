@@ -0,0 +1,415 @@
+# pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <initializer_list>
+#include "Trace.hpp"
+
+// Included from Vector.hpp. Packed specialization: 64 bits per word, bits past
+// length() in the last word are always zero so whole words can be counted,
+// scanned and combined without masking.
+template <>
+class Vector<bool> {
+public:
+    typedef uint64_t Word;
+    static const size_t BITS = 64;
+    static const size_t npos = (size_t)-1;
+
+private:
+    Word* words;
+    size_t size;                    // bits in use
+    size_t capacity;                // bits allocated, a multiple of BITS
+
+#ifdef CHIMPSTL_STATS
+    size_t reallocations = 0;
+    size_t bytesMoved = 0;
+#endif
+
+#ifdef CHIMPSTL_TRACE
+    mutable TraceCounters traceCounters;
+    void trace(TraceEvent event, size_t amount) const { recordTrace(traceCounters, event, this, amount); }
+#else
+    void trace(TraceEvent, size_t) const {}
+#endif
+
+    static size_t wordsFor(size_t bits) { return (bits + BITS - 1) / BITS; }
+
+    void grow(size_t bits);
+    size_t findFrom(size_t start) const;
+    void checkSameLength(const Vector<bool>& other) const;
+
+public:
+    // PROXY REFERENCE
+    class Reference {
+    private:
+        Word* word;
+        Word mask;
+    public:
+        Reference(Word* word, Word mask) : word(word), mask(mask) {}
+
+        operator bool() const { return (*word & mask) != 0; }
+        Reference& operator=(bool value) {
+            if(value) *word |= mask;
+            else *word &= ~mask;
+            return *this;
+        }
+        Reference& operator=(const Reference& other) { return *this = bool(other); }
+        void flip() { *word ^= mask; }
+        friend void swap(Reference a, Reference b) { bool tmp = a; a = bool(b); b = tmp; }
+    };
+
+    // CONSTRUCTORS
+
+    // 1. Default Constructor
+    Vector() : words(nullptr), size(0), capacity(0) {}
+
+    // 2. Constructor
+    Vector(int n, bool value = false) : words(nullptr), size(0), capacity(0) {
+        resize(n, value);
+    }
+
+    // 3. Copy Constructor
+    Vector(const Vector<bool>& other) : words(nullptr), size(0), capacity(0) {
+        grow(other.size);
+        if(other.size) std::memcpy(words, other.words, wordsFor(other.size) * sizeof(Word));
+        size = other.size;
+    }
+
+    // 4. Brace-enclosed initialized list Constructor
+    Vector(std::initializer_list<bool> init) : words(nullptr), size(0), capacity(0) {
+        grow(init.size());
+        for(bool value : init) push_back(value);
+    }
+
+    // 5. Move Constructor
+    Vector(Vector&& other) noexcept : words(other.words), size(other.size), capacity(other.capacity) {
+        other.words = nullptr;
+        other.size = 0;
+        other.capacity = 0;
+    }
+
+    // ITERATOR
+    struct ConstIterator;
+
+    struct Iterator {
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = bool;
+        using pointer           = void;
+        using reference         = Reference;
+
+        Iterator(Word* words = nullptr, size_t index = 0) : words(words), index(index) {}
+
+        reference operator*() const { return Reference(words + index / BITS, Word(1) << (index % BITS)); }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        Iterator& operator++() { index++; return *this; }
+        Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
+        Iterator& operator--() { index--; return *this; }
+        Iterator operator--(int) { Iterator tmp = *this; --(*this); return tmp; }
+
+        Iterator operator+(difference_type n) const { return Iterator(words, index + n); }
+        Iterator operator-(difference_type n) const { return Iterator(words, index - n); }
+        difference_type operator-(const Iterator& other) const { return (difference_type)index - (difference_type)other.index; }
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+
+        Iterator& operator+=(difference_type n) { index += n; return *this; }
+        Iterator& operator-=(difference_type n) { index -= n; return *this; }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.index == b.index; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.index != b.index; }
+        friend bool operator< (const Iterator& a, const Iterator& b) { return a.index < b.index; }
+        friend bool operator> (const Iterator& a, const Iterator& b) { return a.index > b.index; }
+        friend bool operator<=(const Iterator& a, const Iterator& b) { return a.index <= b.index; }
+        friend bool operator>=(const Iterator& a, const Iterator& b) { return a.index >= b.index; }
+
+    private:
+        friend struct ConstIterator;
+        Word* words;
+        size_t index;
+    };
+
+    struct ConstIterator {
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = bool;
+        using pointer           = void;
+        using reference         = bool;
+
+        ConstIterator(const Word* words = nullptr, size_t index = 0) : words(words), index(index) {}
+        ConstIterator(const Iterator& it) : words(it.words), index(it.index) {}
+
+        reference operator*() const { return (words[index / BITS] >> (index % BITS)) & 1; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        ConstIterator& operator++() { index++; return *this; }
+        ConstIterator operator++(int) { ConstIterator tmp = *this; ++(*this); return tmp; }
+        ConstIterator& operator--() { index--; return *this; }
+        ConstIterator operator--(int) { ConstIterator tmp = *this; --(*this); return tmp; }
+
+        ConstIterator operator+(difference_type n) const { return ConstIterator(words, index + n); }
+        ConstIterator operator-(difference_type n) const { return ConstIterator(words, index - n); }
+        difference_type operator-(const ConstIterator& other) const { return (difference_type)index - (difference_type)other.index; }
+        friend ConstIterator operator+(difference_type n, const ConstIterator& it) { return it + n; }
+
+        ConstIterator& operator+=(difference_type n) { index += n; return *this; }
+        ConstIterator& operator-=(difference_type n) { index -= n; return *this; }
+
+        friend bool operator==(const ConstIterator& a, const ConstIterator& b) { return a.index == b.index; }
+        friend bool operator!=(const ConstIterator& a, const ConstIterator& b) { return a.index != b.index; }
+        friend bool operator< (const ConstIterator& a, const ConstIterator& b) { return a.index < b.index; }
+        friend bool operator> (const ConstIterator& a, const ConstIterator& b) { return a.index > b.index; }
+        friend bool operator<=(const ConstIterator& a, const ConstIterator& b) { return a.index <= b.index; }
+        friend bool operator>=(const ConstIterator& a, const ConstIterator& b) { return a.index >= b.index; }
+
+    private:
+        const Word* words;
+        size_t index;
+    };
+
+    Iterator begin()  { return Iterator(words, 0); }
+    Iterator end()    { return Iterator(words, size); }
+    ConstIterator begin() const { return ConstIterator(words, 0); }
+    ConstIterator end()   const { return ConstIterator(words, size); }
+    ConstIterator cbegin() const { return ConstIterator(words, 0); }
+    ConstIterator cend()   const { return ConstIterator(words, size); }
+
+    ReverseIterator<Iterator> rbegin() { return ReverseIterator<Iterator>(end()); }
+    ReverseIterator<Iterator> rend() { return ReverseIterator<Iterator>(begin()); }
+    ReverseIterator<ConstIterator> rbegin() const { return ReverseIterator<ConstIterator>(end()); }
+    ReverseIterator<ConstIterator> rend() const { return ReverseIterator<ConstIterator>(begin()); }
+
+    // MEMBER FUNCTIONS
+
+    size_t length() const { return size;      }
+    bool empty()    const { return size == 0; }
+    bool front()    const { return (*this)[0]; }
+    bool back()     const { return (*this)[(int)size - 1]; }
+    Word* data()             { return words; }              // wordsFor(length()) packed words, bit i of
+    const Word* data() const { return words; }              // word w is element w * 64 + i
+
+    void push_back(bool value) {
+        if(size == capacity) grow(capacity == 0 ? BITS : capacity * 2);
+        if(value) words[size / BITS] |= Word(1) << (size % BITS);
+        size++;
+    }
+
+    void pop_back() {
+        if(size == 0) return;
+        size--;
+        words[size / BITS] &= ~(Word(1) << (size % BITS));
+    }
+
+    void clear() {
+        if(words) std::memset(words, 0, wordsFor(size) * sizeof(Word));
+        size = 0;
+    }
+
+    Reference at(int index) { return (*this)[index]; }
+    void resize(int n, bool value = false);
+    void reserve(int n) { if((size_t)n > capacity) grow(n); }
+
+#ifdef CHIMPSTL_TRACE
+    const TraceCounters& trace_counters() const { return traceCounters; }
+#endif
+
+#ifdef CHIMPSTL_STATS
+    // STATISTICS (compiled only with -DCHIMPSTL_STATS). Same record as the
+    // primary template; size and capacity count bits.
+    typedef Vector<unsigned char>::Stats Stats;
+
+    Stats stats() const {
+        return { size, capacity, capacity / 8, size ? (double)capacity / size : 0.0, reallocations, bytesMoved };
+    }
+#endif
+
+    // WORD-LEVEL OPERATIONS
+    size_t count() const;                                   // number of set bits
+    size_t find_first() const { return findFrom(0); }       // npos when no bit is set
+    size_t find_next(size_t pos) const { return findFrom(pos + 1); }
+    void set(size_t first, size_t last, bool value = true); // sets [first, last)
+    void reset(size_t first, size_t last) { set(first, last, false); }
+    void flip();
+
+    Vector<bool>& operator&=(const Vector<bool>& other);
+    Vector<bool>& operator|=(const Vector<bool>& other);
+    Vector<bool>& operator^=(const Vector<bool>& other);
+    Vector<bool>& and_not(const Vector<bool>& other);       // clears every bit set in other
+
+    // OVERLOADED OPERATORS
+    Reference operator[](int index) {
+        if(index < 0 || (size_t)index >= size) {
+            std::cerr << "Index " << index << " out of bound." << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        return Reference(words + index / BITS, Word(1) << (index % BITS));
+    }
+
+    bool operator[](int index) const {
+        if(index < 0 || (size_t)index >= size) {
+            std::cerr << "Index " << index << " out of bound." << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        return (words[index / BITS] >> (index % BITS)) & 1;
+    }
+
+    Vector<bool>& operator=(const Vector<bool>& other) {    /* Copy Assignment Operator */
+        if(this != &other) {
+            if(other.size > capacity) grow(other.size);
+            if(size > other.size) std::memset(words, 0, wordsFor(size) * sizeof(Word));
+            if(other.size) std::memcpy(words, other.words, wordsFor(other.size) * sizeof(Word));
+            size = other.size;
+        }
+        return *this;
+    }
+
+    Vector<bool>& operator=(Vector&& other) noexcept {      /* Move Assignment Operator */
+        if(this != &other) {
+            delete[] words;
+            words = other.words;
+            size = other.size;
+            capacity = other.capacity;
+
+            other.words = nullptr;
+            other.size = 0;
+            other.capacity = 0;
+        }
+        return *this;
+    }
+
+    friend bool operator==(const Vector<bool>& lhs, const Vector<bool>& rhs) {
+        return lhs.size == rhs.size && (lhs.size == 0 || !std::memcmp(lhs.words, rhs.words, wordsFor(lhs.size) * sizeof(Word)));
+    }
+    friend bool operator!=(const Vector<bool>& lhs, const Vector<bool>& rhs) { return !(lhs == rhs); }
+
+    // Destructors
+    ~Vector() {
+        delete[] words;
+    }
+};
+
+inline void Vector<bool>::grow(size_t bits) {
+    size_t newCapacity = wordsFor(bits) * BITS;
+    if(newCapacity <= capacity) return;
+
+    trace(TraceEvent::Allocate, newCapacity / 8);
+    Word* newWords = new Word[newCapacity / BITS]();
+#ifdef CHIMPSTL_STATS
+    reallocations++;
+    bytesMoved += wordsFor(size) * sizeof(Word);
+#endif
+    if(words) {
+        std::memcpy(newWords, words, wordsFor(size) * sizeof(Word));
+        trace(TraceEvent::Reallocate, wordsFor(size) * sizeof(Word));
+    }
+
+    delete[] words;
+    words = newWords;
+    capacity = newCapacity;
+}
+
+inline void Vector<bool>::resize(int n, bool value) {
+    size_t target = n;
+    if(target > capacity) grow(target);
+
+    if(target > size) {
+        size_t old = size;
+        size = target;
+        set(old, target, value);
+    }
+    else {
+        set(target, size, false);
+        size = target;
+    }
+}
+
+inline size_t Vector<bool>::findFrom(size_t start) const {
+    if(start >= size) return npos;
+
+    size_t w = start / BITS;
+    size_t last = wordsFor(size);
+    Word current = words[w] & (~Word(0) << (start % BITS));
+    while(!current) {
+        if(++w == last) return npos;
+        current = words[w];
+    }
+    return w * BITS + std::countr_zero(current);
+}
+
+inline size_t Vector<bool>::count() const {
+    size_t total = 0;
+    size_t n = wordsFor(size);
+    for(size_t i = 0; i < n; i++) {
+        total += std::popcount(words[i]);
+    }
+    return total;
+}
+
+inline void Vector<bool>::set(size_t first, size_t last, bool value) {
+    if(first >= last) return;
+    if(last > size) {
+        std::cerr << "Range end " << last << " out of bound." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    size_t firstWord = first / BITS;
+    size_t lastWord = (last - 1) / BITS;
+    Word firstMask = ~Word(0) << (first % BITS);
+    Word lastMask = ~Word(0) >> (BITS - 1 - (last - 1) % BITS);
+
+    if(firstWord == lastWord) firstMask &= lastMask;
+    if(value) words[firstWord] |= firstMask;
+    else words[firstWord] &= ~firstMask;
+    if(firstWord == lastWord) return;
+
+    Word fill = value ? ~Word(0) : 0;
+    for(size_t i = firstWord + 1; i < lastWord; i++) {
+        words[i] = fill;
+    }
+    if(value) words[lastWord] |= lastMask;
+    else words[lastWord] &= ~lastMask;
+}
+
+inline void Vector<bool>::flip() {
+    size_t n = wordsFor(size);
+    for(size_t i = 0; i < n; i++) {
+        words[i] = ~words[i];
+    }
+    if(size % BITS) words[n - 1] &= ~Word(0) >> (BITS - size % BITS);
+}
+
+inline void Vector<bool>::checkSameLength(const Vector<bool>& other) const {
+    if(size != other.size) {
+        std::cerr << "Bitwise operation on vectors of length " << size << " and " << other.size << "." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+inline Vector<bool>& Vector<bool>::operator&=(const Vector<bool>& other) {
+    checkSameLength(other);
+    size_t n = wordsFor(size);
+    for(size_t i = 0; i < n; i++) words[i] &= other.words[i];
+    return *this;
+}
+
+inline Vector<bool>& Vector<bool>::operator|=(const Vector<bool>& other) {
+    checkSameLength(other);
+    size_t n = wordsFor(size);
+    for(size_t i = 0; i < n; i++) words[i] |= other.words[i];
+    return *this;
+}
+
+inline Vector<bool>& Vector<bool>::operator^=(const Vector<bool>& other) {
+    checkSameLength(other);
+    size_t n = wordsFor(size);
+    for(size_t i = 0; i < n; i++) words[i] ^= other.words[i];
+    return *this;
+}
+
+inline Vector<bool>& Vector<bool>::and_not(const Vector<bool>& other) {
+    checkSameLength(other);
+    size_t n = wordsFor(size);
+    for(size_t i = 0; i < n; i++) words[i] &= ~other.words[i];
+    return *this;
+}
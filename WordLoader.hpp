@@ -0,0 +1,152 @@
+# pragma once
+#include <string_view>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Vector.hpp"
+#include "Trie.hpp"
+#include "ChimpMap.hpp"
+
+// Read-only memory mapping of a whole file, unmapped on destruction.
+class MappedFile {
+private:
+    const char* bytes;
+    size_t size;
+
+public:
+    explicit MappedFile(const char* path) : bytes(nullptr), size(0) {
+        int fd = open(path, O_RDONLY);
+        struct stat info;
+        if(fd < 0 || fstat(fd, &info) != 0) {
+            std::cerr << "Cannot open " << path << "." << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        size = info.st_size;
+        if(size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(mapped == MAP_FAILED) {
+                std::cerr << "Cannot map " << path << "." << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(mapped);
+        }
+        close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if(bytes) munmap(const_cast<char*>(bytes), size);
+    }
+
+    std::string_view view() const { return std::string_view(bytes, size); }
+};
+
+// Calls fn(line) for every non-empty line of text, without copying. Newlines
+// are located with memchr, which libc implements with vector instructions;
+// a trailing '\r' is dropped.
+template <class Function>
+void for_each_line(std::string_view text, Function fn) {
+    const char* cursor = text.data();
+    const char* end = cursor + text.size();
+    while(cursor < end) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char* stop = newline ? newline : end;
+
+        size_t length = stop - cursor;
+        if(length > 0 && cursor[length - 1] == '\r') length--;
+        if(length > 0) fn(std::string_view(cursor, length));
+
+        cursor = stop + 1;
+    }
+}
+
+// Trie and ChimpMap index their children by ch - 'a', so only words made of
+// 'a'..'z' may reach them.
+inline bool is_lowercase_word(std::string_view word) {
+    for(char ch : word) {
+        if(ch < 'a' || ch > 'z') return false;
+    }
+    return true;
+}
+
+// Inserts word and returns true, or returns false if it is not a lowercase word.
+inline bool load_word(Trie& trie, std::string_view word) {
+    if(!is_lowercase_word(word)) return false;
+    trie.insert(word);
+    return true;
+}
+
+template <typename T>
+bool load_word(ChimpMap<T>& map, std::string_view word) {
+    if(!is_lowercase_word(word)) return false;
+    map[word];
+    return true;
+}
+
+// Loads a word list (one lowercase word per line) into a Trie or ChimpMap
+// straight from a memory mapping. With threads > 1 the file is cut into that
+// many ranges at line boundaries, each range is loaded into its own container
+// on its own thread, and the partial containers are merged into out in order.
+// Lines with characters outside 'a'..'z' are skipped and reported once on
+// std::cerr; the number of skipped lines is returned.
+template <class Container>
+size_t load_words(const char* path, Container& out, int threads = 1) {
+    MappedFile file(path);
+    std::string_view text = file.view();
+    size_t skipped = 0;
+
+    if(threads <= 1 || text.size() < (size_t)threads) {
+        for_each_line(text, [&out, &skipped](std::string_view word) {
+            if(!load_word(out, word)) skipped++;
+        });
+        if(skipped > 0) {
+            std::cerr << "Skipped " << skipped << " non-lowercase lines in " << path << "." << std::endl;
+        }
+        return skipped;
+    }
+
+    Vector<std::string_view> ranges;
+    size_t begin = 0;
+    for(int i = 1; i <= threads && begin < text.size(); i++) {
+        size_t cut = i == threads ? text.size() : text.size() / threads * i;
+        if(cut < begin) cut = begin;
+        while(cut < text.size() && text[cut - 1] != '\n') cut++;
+        ranges.push_back(text.substr(begin, cut - begin));
+        begin = cut;
+    }
+
+    Vector<Container*> partials;
+    Vector<std::thread*> workers;
+    Vector<size_t> rejected((int)ranges.length(), 0);
+    for(size_t i = 0; i < ranges.length(); i++) {
+        Container* partial = new Container();
+        std::string_view range = ranges[i];
+        size_t* count = &rejected[i];
+        partials.push_back(partial);
+        workers.push_back(new std::thread([partial, range, count]() {
+            for_each_line(range, [partial, count](std::string_view word) {
+                if(!load_word(*partial, word)) (*count)++;
+            });
+        }));
+    }
+
+    for(size_t i = 0; i < workers.length(); i++) {
+        workers[i]->join();
+        delete workers[i];
+        out.merge(std::move(*partials[i]));
+        delete partials[i];
+        skipped += rejected[i];
+    }
+    if(skipped > 0) {
+        std::cerr << "Skipped " << skipped << " non-lowercase lines in " << path << "." << std::endl;
+    }
+    return skipped;
+}
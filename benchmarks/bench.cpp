@@ -0,0 +1,516 @@
+// Benchmarks ChimpanzeeSTL containers against their standard library
+// counterparts. Every case reports the best of several runs as time per
+// operation, heap allocations and bytes per operation, and the peak heap the
+// timed body held on top of what was live when it started (for an insert case,
+// the container's footprint). Pass --json <file> for machine-readable output.
+//
+//   chimp_bench [--size N] [--repeat R] [--json FILE]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <thread>
+
+#include "Vector.hpp"
+#include "ChimpMap.hpp"
+#include "SoAVector.hpp"
+#include "FlatMap.hpp"
+#include "RingBuffer.hpp"
+
+// ALLOCATION COUNTING
+// Every block carries its size in a header, so delete can keep a count of the
+// bytes currently live and the high-water mark since the last resetPeak().
+static std::atomic<size_t> allocationCount{0};
+static std::atomic<size_t> allocationBytes{0};
+static std::atomic<size_t> liveBytes{0};
+static std::atomic<size_t> peakBytes{0};
+static const size_t HEADER = alignof(std::max_align_t);
+
+static void* allocate(std::size_t bytes) {
+    allocationCount++;
+    allocationBytes += bytes;
+    size_t live = liveBytes += bytes;
+    size_t peak = peakBytes.load(std::memory_order_relaxed);
+    while(live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+    char* block = static_cast<char*>(std::malloc(HEADER + bytes));
+    if(!block) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(block) = bytes;
+    return block + HEADER;
+}
+
+static void deallocate(void* p) noexcept {
+    if(!p) return;
+    char* block = static_cast<char*>(p) - HEADER;
+    liveBytes -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+
+void* operator new(std::size_t bytes) { return allocate(bytes); }
+void* operator new[](std::size_t bytes) { return allocate(bytes); }
+void operator delete(void* p) noexcept { deallocate(p); }
+void operator delete[](void* p) noexcept { deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { deallocate(p); }
+
+// Restarts the high-water mark from the bytes live now and returns them.
+static size_t resetPeak() {
+    size_t live = liveBytes;
+    peakBytes = live;
+    return live;
+}
+
+// HARNESS
+struct Result {
+    std::string name;
+    size_t ops;
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;
+    double peakHeapKb;              // heap held by body() above what was live before it
+};
+
+static std::vector<Result> results;
+static int repeat = 3;
+static volatile size_t sink;
+
+// Runs setup() untimed, then body() timed, repeat times; keeps the fastest run.
+static void run(const std::string& name, size_t ops, const std::function<void()>& setup,
+                const std::function<void()>& body) {
+    Result best{name, ops, 1e300, 0, 0, 0};
+    for(int r = 0; r < repeat; r++) {
+        setup();
+        size_t allocs = allocationCount, bytes = allocationBytes;
+        size_t live = resetPeak();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto stop = std::chrono::steady_clock::now();
+        best.peakHeapKb = std::max(best.peakHeapKb, (peakBytes - live) / 1024.0);
+
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count() / ops;
+        if(ns < best.nsPerOp) {
+            best.nsPerOp = ns;
+            best.allocsPerOp = (double)(allocationCount - allocs) / ops;
+            best.bytesPerOp = (double)(allocationBytes - bytes) / ops;
+        }
+    }
+    results.push_back(best);
+    std::printf("%-40s %10.2f ns/op %8.3f allocs/op %10.1f B/op %10.1f KB peak heap\n", name.c_str(),
+                best.nsPerOp, best.allocsPerOp, best.bytesPerOp, best.peakHeapKb);
+}
+
+static void run(const std::string& name, size_t ops, const std::function<void()>& body) {
+    run(name, ops, [] {}, body);
+}
+
+// KEY DISTRIBUTIONS
+// Word-like keys: lengths and letters follow rough English frequencies, so
+// the trie sees realistic prefix sharing. Lookups draw hits from a Zipf
+// distribution over the inserted keys; misses are words never inserted.
+static std::string randomWord(std::mt19937& rng) {
+    static const double lengthWeights[] = {0, 0, 3, 7, 11, 13, 14, 14, 12, 9, 7, 5, 3, 2, 1};
+    static const double letterWeights[] = {8.2, 1.5, 2.8, 4.3, 12.7, 2.2, 2.0, 6.1, 7.0, 0.2, 0.8, 4.0, 2.4,
+                                           6.7, 7.5, 1.9, 0.1, 6.0, 6.3, 9.1, 2.8, 1.0, 2.4, 0.2, 2.0, 0.1};
+    static std::discrete_distribution<int> length(std::begin(lengthWeights), std::end(lengthWeights));
+    static std::discrete_distribution<int> letter(std::begin(letterWeights), std::end(letterWeights));
+
+    std::string word(length(rng), ' ');
+    for(char& ch : word) ch = 'a' + letter(rng);
+    return word;
+}
+
+struct Keys {
+    std::vector<std::string> inserted;      // distinct, in insertion order
+    std::vector<std::string> hits;          // Zipf-distributed lookups of inserted keys
+    std::vector<std::string> misses;        // keys that were never inserted
+};
+
+static Keys makeKeys(size_t n) {
+    std::mt19937 rng(42);
+    Keys keys;
+    std::unordered_set<std::string> seen;
+    while(keys.inserted.size() < n) {
+        std::string word = randomWord(rng);
+        if(seen.insert(word).second) keys.inserted.push_back(word);
+    }
+    while(keys.misses.size() < n) {
+        std::string word = randomWord(rng);
+        if(!seen.count(word)) keys.misses.push_back(word);
+    }
+
+    std::vector<double> zipf(n);
+    for(size_t i = 0; i < n; i++) zipf[i] = 1.0 / (i + 1);
+    std::discrete_distribution<size_t> rank(zipf.begin(), zipf.end());
+    for(size_t i = 0; i < n; i++) keys.hits.push_back(keys.inserted[rank(rng)]);
+    return keys;
+}
+
+// VECTOR BENCHMARKS
+template <class V>
+static void vectorSuite(const std::string& label, size_t n) {
+    V v;
+    run(label + "/push_back", n, [&] { v = V(); }, [&] {
+        for(size_t i = 0; i < n; i++) v.push_back((int)i);
+    });
+    run(label + "/reserve+push_back", n, [&] { v = V(); }, [&] {
+        v.reserve((int)n);
+        for(size_t i = 0; i < n; i++) v.push_back((int)i);
+    });
+
+    size_t small = std::min<size_t>(n, 20000);
+    run(label + "/insert_middle", small, [&] { v = V(); v.reserve(2 * (int)small); v.push_back(0); }, [&] {
+        for(size_t i = 0; i < small; i++) v.insert(v.begin() + v.size() / 2, (int)i);
+    });
+    run(label + "/erase_middle", small, [&] {
+        v = V();
+        for(size_t i = 0; i < small + 1; i++) v.push_back((int)i);
+    }, [&] {
+        for(size_t i = 0; i < small; i++) v.erase(v.begin() + v.size() / 2);
+    });
+
+    v = V();
+    for(size_t i = 0; i < n; i++) v.push_back((int)i);
+    run(label + "/iterate", n, [&] {
+        size_t sum = 0;
+        for(auto it = v.begin(); it != v.end(); ++it) sum += *it;
+        sink = sum;
+    });
+}
+
+// Adapts Vector to the std::vector spelling used by vectorSuite.
+struct ChimpVector : Vector<int> {
+    size_t size() const { return length(); }
+};
+
+// BITMAP BENCHMARKS
+static void bitmapSuite(size_t n) {
+    size_t bits = n * 64;
+    std::mt19937 rng(7);
+    Vector<bool> mask((int)bits);
+    std::vector<bool> stdMask(bits);
+    for(size_t i = 0; i < bits; i += 1 + rng() % 64) {
+        mask[(int)i] = true;
+        stdMask[i] = true;
+    }
+
+    run("Vector<bool>/count", bits, [&] { sink = mask.count(); });
+    run("std::vector<bool>/count", bits, [&] { sink = std::count(stdMask.begin(), stdMask.end(), true); });
+    run("Vector<bool>/find_next", bits, [&] {
+        size_t found = 0;
+        for(size_t i = mask.find_first(); i != Vector<bool>::npos; i = mask.find_next(i)) found++;
+        sink = found;
+    });
+    run("std::vector<bool>/find_next", bits, [&] {
+        size_t found = 0;
+        for(size_t i = 0; i < bits; i++) found += stdMask[i];
+        sink = found;
+    });
+}
+
+// COLUMN SCAN BENCHMARKS
+// Sums one float field of a 32-byte record, stored as an array of structs
+// and as SoAVector columns.
+struct Particle {
+    float x, y, z;
+    float mass;
+    int id;
+    int flags;
+    double energy;
+};
+
+static void columnSuite(size_t n) {
+    Vector<Particle> aos;
+    SoAVector<float, float, float, float, int, int, double> soa;
+    run("Vector<struct>/push_back", n, [&] { aos = Vector<Particle>(); }, [&] {
+        for(size_t i = 0; i < n; i++) aos.push_back({1, 2, 3, (float)i, (int)i, 0, 0.5});
+    });
+    run("SoAVector/push_back", n, [&] { soa = SoAVector<float, float, float, float, int, int, double>(); }, [&] {
+        for(size_t i = 0; i < n; i++) soa.push_back(1, 2, 3, (float)i, (int)i, 0, 0.5);
+    });
+
+    run("Vector<struct>/scan_field", n, [&] {
+        float sum = 0;
+        const Particle* p = aos.data();
+        for(size_t i = 0; i < n; i++) sum += p[i].mass;
+        sink = (size_t)sum;
+    });
+    run("SoAVector/scan_field", n, [&] {
+        float sum = 0;
+        const float* mass = soa.data<3>();
+        for(size_t i = 0; i < n; i++) sum += mass[i];
+        sink = (size_t)sum;
+    });
+}
+
+// QUEUE BENCHMARKS
+// A FIFO holding `depth` items in steady state: every op pushes one and pops one.
+static void queueSuite(size_t n) {
+    const int depth = 1024;
+    run("Vector/fifo_erase_front", n, [&] {
+        Vector<int> fifo;
+        for(int i = 0; i < depth; i++) fifo.push_back(i);
+        size_t sum = 0;
+        for(size_t i = 0; i < n; i++) {
+            fifo.push_back((int)i);
+            sum += fifo[0];
+            fifo.erase(fifo.begin());
+        }
+        sink = sum;
+    });
+    run("RingBuffer/fifo", n, [&] {
+        RingBuffer<int> fifo(2 * depth);
+        for(int i = 0; i < depth; i++) fifo.push(i);
+        size_t sum = 0;
+        int value = 0;
+        for(size_t i = 0; i < n; i++) {
+            fifo.push((int)i);
+            fifo.pop(value);
+            sum += value;
+        }
+        sink = sum;
+    });
+
+    // Hand-off between two threads, one item or a batch of 64 at a time.
+    for(size_t batch : {(size_t)1, (size_t)64}) {
+        SPSCQueue<int> queue(depth);
+        run("SPSCQueue/transfer_batch" + std::to_string(batch), n, [&] {
+            std::thread producer([&] {
+                Vector<int> items((int)batch);
+                for(size_t sent = 0; sent < n;) {
+                    size_t count = std::min(batch, n - sent);
+                    size_t pushed = batch == 1 ? queue.push((int)sent) : queue.push_n(items.data(), count);
+                    if(pushed == 0) std::this_thread::yield();
+                    sent += pushed;
+                }
+            });
+            Vector<int> items((int)batch);
+            for(size_t received = 0; received < n;) {
+                size_t popped = queue.pop_n(items.data(), batch);
+                if(popped == 0) std::this_thread::yield();
+                received += popped;
+            }
+            producer.join();
+        });
+    }
+}
+
+// MAP BENCHMARKS
+template <class M>
+static void mapSuite(const std::string& label, const Keys& keys, size_t (*iterate)(M&)) {
+    size_t n = keys.inserted.size();
+    M* map = nullptr;
+    auto fill = [&] {
+        delete map;
+        map = new M();
+        for(const std::string& key : keys.inserted) (*map)[key] = 1;
+    };
+
+    run(label + "/insert", n, [&] { delete map; map = new M(); }, [&] {
+        for(const std::string& key : keys.inserted) (*map)[key] = 1;
+    });
+    run(label + "/lookup_hit", n, [&] {
+        size_t found = 0;
+        for(const std::string& key : keys.hits) found += map->count(key);
+        sink = found;
+    });
+    run(label + "/lookup_miss", n, [&] {
+        size_t found = 0;
+        for(const std::string& key : keys.misses) found += map->count(key);
+        sink = found;
+    });
+    run(label + "/iterate", n, [&] { sink = iterate(*map); });
+    run(label + "/erase", n, fill, [&] {
+        for(const std::string& key : keys.inserted) map->erase(key);
+    });
+    delete map;
+}
+
+static size_t iterateChimp(ChimpMap<int>& map) {
+    size_t sum = 0;
+    auto it = map.begin();
+    for(size_t i = 0; i < map.length(); i++, ++it) sum += (*it).second;
+    return sum;
+}
+
+template <class M>
+static size_t iterateStd(M& map) {
+    size_t sum = 0;
+    for(const auto& entry : map) sum += entry.second;
+    return sum;
+}
+
+// Word counting over the Zipf lookups: the old two-walk pattern against update().
+static void upsertSuite(const Keys& keys) {
+    size_t n = keys.hits.size();
+    ChimpMap<int> counts;
+    run("ChimpMap/count+operator[]", n, [&] { counts.clear(); }, [&] {
+        for(const std::string& key : keys.hits) {
+            if(counts.count(key)) counts[key]++;
+            else counts[key] = 1;
+        }
+    });
+    run("ChimpMap/update", n, [&] { counts.clear(); }, [&] {
+        for(const std::string& key : keys.hits) counts.update(key, [](int& c) { c++; });
+    });
+}
+
+// Batch insertion and integer keys, which only FlatMap among the maps here supports.
+static void flatMapSuite(const Keys& keys) {
+    size_t n = keys.inserted.size();
+    std::vector<std::pair<std::string, int>> batch;
+    for(const std::string& key : keys.inserted) batch.push_back({key, 1});
+
+    FlatMap<std::string, int> map;
+    run("FlatMap@10k/insert_batch", n, [&] { map = FlatMap<std::string, int>(); }, [&] {
+        map.insert(batch.begin(), batch.end());
+    });
+
+    std::mt19937 rng(3);
+    std::vector<int> ints, probes;
+    for(size_t i = 0; i < n; i++) ints.push_back((int)(rng() >> 1));
+    for(size_t i = 0; i < n; i++) probes.push_back(ints[rng() % n]);
+    FlatMap<int, int> flatInts;
+    std::map<int, int> stdInts;
+    for(int key : ints) {
+        flatInts[key] = 1;
+        stdInts[key] = 1;
+    }
+    run("FlatMap<int>@10k/lookup_hit", n, [&] {
+        size_t found = 0;
+        for(int key : probes) found += flatInts.count(key);
+        sink = found;
+    });
+    run("std::map<int>@10k/lookup_hit", n, [&] {
+        size_t found = 0;
+        for(int key : probes) found += stdInts.count(key);
+        sink = found;
+    });
+}
+
+// 64-bit IDs: the radix ChimpMap against formatting each ID as a string key
+// (digits spelled as letters, since string keys are lowercase).
+static std::string idToKey(uint64_t id) {
+    std::string key = std::to_string(id);
+    for(char& ch : key) ch = 'a' + (ch - '0');
+    return key;
+}
+
+static void idMapSuite(size_t n) {
+    std::mt19937_64 rng(11);
+    std::vector<uint64_t> ids, probes;
+    for(size_t i = 0; i < n; i++) ids.push_back(rng());
+    for(size_t i = 0; i < n; i++) probes.push_back(ids[rng() % n]);
+
+    ChimpMap<int> byString;
+    ChimpMap<int, uint64_t> radix;
+    ChimpMap<int, RadixKey<uint64_t, 16>> radix16;
+    std::unordered_map<uint64_t, int> hashed;
+    run("ChimpMap<string id>/insert", n, [&] { byString.clear(); }, [&] {
+        for(uint64_t id : ids) byString[idToKey(id)] = 1;
+    });
+    run("ChimpMap<uint64_t>/insert", n, [&] { radix.clear(); }, [&] {
+        for(uint64_t id : ids) radix[id] = 1;
+    });
+    run("ChimpMap<uint64_t,16>/insert", n, [&] { radix16.clear(); }, [&] {
+        for(uint64_t id : ids) radix16[id] = 1;
+    });
+    run("std::unordered_map<uint64_t>/insert", n, [&] { hashed.clear(); }, [&] {
+        for(uint64_t id : ids) hashed[id] = 1;
+    });
+
+    run("ChimpMap<string id>/lookup_hit", n, [&] {
+        size_t found = 0;
+        for(uint64_t id : probes) found += byString.count(idToKey(id));
+        sink = found;
+    });
+    run("ChimpMap<uint64_t>/lookup_hit", n, [&] {
+        size_t found = 0;
+        for(uint64_t id : probes) found += radix.count(id);
+        sink = found;
+    });
+    run("ChimpMap<uint64_t,16>/lookup_hit", n, [&] {
+        size_t found = 0;
+        for(uint64_t id : probes) found += radix16.count(id);
+        sink = found;
+    });
+    run("std::unordered_map<uint64_t>/lookup_hit", n, [&] {
+        size_t found = 0;
+        for(uint64_t id : probes) found += hashed.count(id);
+        sink = found;
+    });
+    run("ChimpMap<uint64_t>/iterate", n, [&] {
+        size_t sum = 0;
+        for(auto it = radix.begin(); it != radix.end(); ++it) sum += it->second;
+        sink = sum;
+    });
+}
+
+// OUTPUT
+static void writeJson(const char* path) {
+    FILE* out = std::fopen(path, "w");
+    if(!out) {
+        std::cerr << "Cannot write " << path << "." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    std::fprintf(out, "[\n");
+    for(size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::fprintf(out, "  {\"name\":\"%s\",\"ops\":%zu,\"ns_per_op\":%.3f,\"allocs_per_op\":%.4f,"
+                          "\"bytes_per_op\":%.2f,\"peak_heap_kb\":%.1f}%s\n",
+                     r.name.c_str(), r.ops, r.nsPerOp, r.allocsPerOp, r.bytesPerOp, r.peakHeapKb,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "]\n");
+    std::fclose(out);
+}
+
+int main(int argc, char** argv) {
+    size_t n = 200000;
+    const char* json = nullptr;
+    for(int i = 1; i < argc; i++) {
+        if(!std::strcmp(argv[i], "--size") && i + 1 < argc) n = std::strtoul(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = std::atoi(argv[++i]);
+        else if(!std::strcmp(argv[i], "--json") && i + 1 < argc) json = argv[++i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [--size N] [--repeat R] [--json FILE]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    vectorSuite<ChimpVector>("Vector", n);
+    vectorSuite<std::vector<int>>("std::vector", n);
+    bitmapSuite(n);
+    columnSuite(n);
+    queueSuite(n);
+
+    Keys keys = makeKeys(n);
+    mapSuite<ChimpMap<int>>("ChimpMap", keys, iterateChimp);
+    mapSuite<std::map<std::string, int>>("std::map", keys, iterateStd);
+    mapSuite<std::unordered_map<std::string, int>>("std::unordered_map", keys, iterateStd);
+    upsertSuite(keys);
+
+    // FlatMap inserts one key at a time in O(n), so it is compared at the
+    // small sizes it is meant for.
+    Keys smallKeys = makeKeys(std::min<size_t>(n, 10000));
+    mapSuite<ChimpMap<int>>("ChimpMap@10k", smallKeys, iterateChimp);
+    mapSuite<FlatMap<std::string, int>>("FlatMap@10k", smallKeys, iterateStd);
+    mapSuite<std::map<std::string, int>>("std::map@10k", smallKeys, iterateStd);
+    flatMapSuite(smallKeys);
+    idMapSuite(n);
+
+    if(json) writeJson(json);
+    return 0;
+}
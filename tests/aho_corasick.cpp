@@ -0,0 +1,70 @@
+// Trie::scan fed one stream in chunks: matches that span chunk boundaries are
+// reported exactly as when the whole text arrives at once, and both agree
+// with a naive search for every pattern.
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Trie.hpp"
+#include "check.hpp"
+
+typedef std::vector<std::pair<int, size_t>> Matches;   // (word id, end offset)
+
+static Matches scanChunks(Trie& trie, const std::string& text, const std::vector<size_t>& cuts) {
+    Matches matches;
+    trie.reset_scan();
+    size_t begin = 0;
+    for(size_t cut : cuts) {
+        trie.scan(std::string_view(text).substr(begin, cut - begin), [&matches](int id, size_t end) { matches.push_back({id, end}); });
+        begin = cut;
+    }
+    trie.scan(std::string_view(text).substr(begin), [&matches](int id, size_t end) { matches.push_back({id, end}); });
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+static Matches naive(const std::vector<std::pair<int, std::string>>& patterns, const std::string& text) {
+    Matches matches;
+    for(const auto& [id, word] : patterns) {
+        for(size_t at = text.find(word); at != std::string::npos; at = text.find(word, at + 1)) {
+            matches.push_back({id, at + word.size()});
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+int main() {
+    Trie trie;
+    std::vector<std::pair<int, std::string>> patterns;
+    for(const char* word : {"he", "she", "his", "hers", "ushers", "a", "aa", "aaa", "abab", "bab"}) {
+        patterns.push_back({trie.insert(word), word});
+    }
+
+    std::string text = "ushers said his shell held hers; aaaa ababab she-he";
+    Matches whole = scanChunks(trie, text, {});
+    CHECK(whole == naive(patterns, text));
+
+    for(size_t cut = 0; cut <= text.size(); cut++) {            // one boundary at every offset
+        CHECK(scanChunks(trie, text, {cut}) == whole);
+    }
+
+    std::vector<size_t> everyByte;
+    for(size_t cut = 1; cut < text.size(); cut++) everyByte.push_back(cut);
+    CHECK(scanChunks(trie, text, everyByte) == whole);
+
+    std::mt19937 rng(5);                                        // random texts over a small alphabet, random cuts
+    for(int round = 0; round < 200; round++) {
+        std::string random;
+        for(int i = 0; i < 300; i++) random += "abehrsu "[rng() % 8];
+        std::vector<size_t> cuts;
+        for(size_t cut = rng() % 20; cut < random.size(); cut += 1 + rng() % 40) cuts.push_back(cut);
+        CHECK(scanChunks(trie, random, cuts) == naive(patterns, random));
+    }
+
+    patterns.push_back({trie.insert("shell"), "shell"});       // inserting rebuilds the automaton
+    CHECK(scanChunks(trie, text, {17}) == naive(patterns, text));
+
+    std::cout << "aho_corasick: ok" << std::endl;
+}
@@ -0,0 +1,13 @@
+# pragma once
+#include <cstdlib>
+#include <iostream>
+
+// Test failures are reported the way the containers report misuse: a message
+// on std::cerr and EXIT_FAILURE, which ctest counts as a failed test.
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if(!(condition)) {                                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            std::exit(EXIT_FAILURE);                                                       \
+        }                                                                                  \
+    } while(0)
@@ -0,0 +1,120 @@
+// SPSCQueue and MPMCQueue under real threads: every value arrives exactly
+// once, and in order for each producer, across many wraparounds of a small ring.
+// A side that finds the ring full or empty yields, so the test also finishes
+// on a single core.
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RingBuffer.hpp"
+#include "check.hpp"
+
+static const int COUNT = 200000;
+
+static void spscInOrder() {
+    SPSCQueue<int> queue(64);
+    std::thread producer([&queue] {
+        int batch[7];
+        for(int next = 0; next < COUNT; ) {
+            if(next % 3 == 0) {                 // mix single pushes with batches
+                int n = 0;
+                while(n < 7 && next + n < COUNT) { batch[n] = next + n; n++; }
+                size_t pushed = queue.push_n(batch, n);
+                if(pushed == 0) std::this_thread::yield();
+                next += (int)pushed;
+            }
+            else if(queue.push(next)) {
+                next++;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int batch[5];
+    while(expected < COUNT) {
+        if(expected % 2 == 0) {
+            size_t n = queue.pop_n(batch, 5);
+            if(n == 0) std::this_thread::yield();
+            for(size_t i = 0; i < n; i++) CHECK(batch[i] == expected++);
+        }
+        else {
+            int value;
+            if(queue.pop(value)) CHECK(value == expected++);
+            else std::this_thread::yield();
+        }
+    }
+    producer.join();
+    CHECK(queue.empty());
+}
+
+static void spscMovesStrings() {
+    SPSCQueue<std::string> queue(8);
+    std::thread producer([&queue] {
+        for(int i = 0; i < COUNT / 10; ) {
+            std::string value = std::to_string(i);
+            if(queue.push(std::move(value))) i++;
+            else std::this_thread::yield();
+        }
+    });
+
+    for(int i = 0; i < COUNT / 10; ) {
+        std::string value;
+        if(queue.pop(value)) CHECK(value == std::to_string(i++));
+        else std::this_thread::yield();
+    }
+    producer.join();
+}
+
+static void mpmcExactlyOnce() {
+    const int PRODUCERS = 4, CONSUMERS = 4, EACH = COUNT / PRODUCERS;
+    MPMCQueue<int> queue(128);
+    std::vector<std::vector<int>> received(CONSUMERS);
+    std::atomic<int> remaining(PRODUCERS * EACH);
+
+    std::vector<std::thread> threads;
+    for(int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&queue, p] {
+            for(int i = 0; i < EACH; ) {
+                if(queue.push(p * EACH + i)) i++;
+                else std::this_thread::yield();
+            }
+        });
+    }
+    for(int c = 0; c < CONSUMERS; c++) {
+        threads.emplace_back([&queue, &received, &remaining, c] {
+            int value;
+            while(remaining.load() > 0) {
+                if(queue.pop(value)) {
+                    received[c].push_back(value);
+                    remaining--;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(std::thread& thread : threads) thread.join();
+
+    std::vector<int> seen(PRODUCERS * EACH, 0);
+    for(const std::vector<int>& values : received) {
+        std::vector<int> last(PRODUCERS, -1);
+        for(int value : values) {
+            seen[value]++;
+            CHECK(value > last[value / EACH]);  // one consumer sees a producer's values in order
+            last[value / EACH] = value;
+        }
+    }
+    for(int count : seen) CHECK(count == 1);
+    CHECK(queue.empty());
+}
+
+int main() {
+    spscInOrder();
+    spscMovesStrings();
+    mpmcExactlyOnce();
+    std::cout << "queues: ok" << std::endl;
+}
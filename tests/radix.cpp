@@ -0,0 +1,107 @@
+// The integer-keyed ChimpMap against std::map: random inserts and erases over
+// dense, sparse, clustered and signed keys, with lower_bound, upper_bound and
+// prefix_range checked along the way.
+#include <map>
+#include <random>
+#include <string>
+#include "ChimpMap.hpp"
+#include "check.hpp"
+
+template <class Map, class K>
+static void checkSame(const Map& map, const std::map<K, std::string>& expected) {
+    CHECK(map.length() == expected.size());
+    auto want = expected.begin();
+    for(auto it = map.begin(); it != map.end(); ++it, ++want) {
+        CHECK(want != expected.end() && it->first == want->first && it->second == want->second);
+    }
+    CHECK(want == expected.end());
+}
+
+// Every key of expected within [first, last) must come out of prefix_range.
+template <class Map, class K>
+static void checkPrefixRange(const Map& map, const std::map<K, std::string>& expected, K prefix, int bits) {
+    typedef std::make_unsigned_t<K> U;
+    const int width = sizeof(K) * 8;
+    auto shares = [&](K key) {
+        U diff = U((U)key ^ (U)prefix);
+        return bits == 0 || (bits == width ? diff == 0 : U(diff >> (width - bits)) == 0);
+    };
+
+    auto [first, last] = map.prefix_range(prefix, bits);
+    size_t found = 0;
+    for(auto it = first; it != last; ++it, found++) CHECK(shares(it->first));
+
+    size_t wanted = 0;
+    for(const auto& entry : expected) wanted += shares(entry.first);
+    CHECK(found == wanted);
+}
+
+template <class Map, class K, class Draw>
+static void againstStdMap(unsigned seed, Draw draw) {
+    std::mt19937_64 rng(seed);
+    Map map;
+    std::map<K, std::string> expected;
+
+    for(int round = 0; round < 30000; round++) {
+        K key = (K)draw(rng);
+        switch(rng() % 5) {
+        case 0:
+            map.insert(key, std::to_string(round));
+            expected.insert({key, std::to_string(round)});
+            break;
+        case 1:
+            map.erase(key);
+            expected.erase(key);
+            break;
+        case 2:
+            map[key] += "x";
+            expected[key] += "x";
+            break;
+        case 3: {
+            auto it = map.lower_bound(key);
+            auto want = expected.lower_bound(key);
+            CHECK(want == expected.end() ? it == map.end() : it != map.end() && it->first == want->first);
+            it = map.upper_bound(key);
+            want = expected.upper_bound(key);
+            CHECK(want == expected.end() ? it == map.end() : it != map.end() && it->first == want->first);
+            break;
+        }
+        default:
+            CHECK(map.count(key) == (expected.count(key) > 0));
+        }
+    }
+    checkSame(map, expected);
+
+    const int width = sizeof(K) * 8;
+    for(int bits : {0, 1, width / 2, width - 3, width}) {
+        for(int i = 0; i < 40; i++) checkPrefixRange(map, expected, (K)draw(rng), bits);
+    }
+
+    while(!expected.empty()) {
+        map.erase(expected.begin()->first);
+        expected.erase(expected.begin());
+    }
+    CHECK(map.empty() && map.begin() == map.end());
+}
+
+int main() {
+    againstStdMap<ChimpMap<std::string, uint64_t>, uint64_t>(1, [](std::mt19937_64& rng) { return rng() % 3000; });
+    againstStdMap<ChimpMap<std::string, uint64_t>, uint64_t>(2, [](std::mt19937_64& rng) { return rng() % 4000 * 0x9E3779B97F4A7C15ull; });
+    againstStdMap<ChimpMap<std::string, uint64_t>, uint64_t>(3, [](std::mt19937_64& rng) {
+        int shift = 8 * (int)(rng() % 8);           // shared high bits, so compressed paths split at every level
+        return (0xABCDEF0123456789ull >> shift << shift) | (rng() % 4);
+    });
+    againstStdMap<ChimpMap<std::string, int64_t>, int64_t>(4, [](std::mt19937_64& rng) { return (int64_t)(rng() % 4001) - 2000; });
+    againstStdMap<ChimpMap<std::string, RadixKey<uint32_t, 16>>, uint32_t>(5, [](std::mt19937_64& rng) { return (uint32_t)(rng() % 200000); });
+    againstStdMap<ChimpMap<std::string, RadixKey<int16_t, 16>>, int16_t>(6, [](std::mt19937_64& rng) { return (int16_t)rng(); });
+    againstStdMap<ChimpMap<std::string, uint8_t>, uint8_t>(7, [](std::mt19937_64& rng) { return (uint8_t)rng(); });
+
+    ChimpMap<std::string, uint32_t> aliased;        // the value's source lives in the node that grows
+    aliased[1] = "one";
+    aliased.insert(2, aliased[1]);
+    aliased.insert(3, aliased[2]);
+    aliased.emplace(1, 3, 'z');
+    CHECK(aliased[1] == "zzz" && aliased[3] == "one");
+
+    std::cout << "radix: ok" << std::endl;
+}
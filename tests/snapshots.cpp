@@ -0,0 +1,110 @@
+// Copy-on-write snapshots of the string and integer ChimpMaps. A writer keeps
+// modifying its map and hands a snapshot to a reader thread after every
+// round; each snapshot must show exactly the round it was taken in, and is
+// released on the reader thread while the writer goes on sharing its nodes.
+#include <map>
+#include <string>
+#include <thread>
+#include "ChimpMap.hpp"
+#include "RingBuffer.hpp"
+#include "check.hpp"
+
+static const int ROUNDS = 2000;
+static const int KEYS = 300;
+
+static std::string wordFor(int n) {                 // lowercase key, as the string map requires
+    std::string word = "k";
+    for(; n > 0; n /= 26) word += char('a' + n % 26);
+    return word;
+}
+
+// Every fixed key holds the round number, so a snapshot showing two different
+// values has seen a later write.
+template <class Map, class KeyOf>
+static void snapshotsWhileWriting(KeyOf keyOf) {
+    SPSCQueue<Map*> handoff(4);
+
+    std::thread reader([&handoff] {
+        for(int round = 1; round <= ROUNDS; ) {
+            Map* snapshot;
+            if(!handoff.pop(snapshot)) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            CHECK(snapshot->length() == (size_t)(KEYS + round));
+            size_t fixed = 0;
+            for(auto it = snapshot->begin(); it != snapshot->end(); ++it) {
+                if(it->second >= 0) {
+                    CHECK(it->second == round);
+                    fixed++;
+                }
+            }
+            CHECK(fixed == (size_t)KEYS);
+            delete snapshot;
+            round++;
+        }
+    });
+
+    Map map;
+    for(int round = 1; round <= ROUNDS; round++) {
+        for(int i = 0; i < KEYS; i++) map[keyOf(i)] = round;
+        map.erase(keyOf(round % KEYS));             // erase and reinsert one key a round
+        map.insert(keyOf(round % KEYS), round);
+        map.insert(keyOf(KEYS + round), -round);    // and grow by one negative-valued key
+
+        Map* snapshot = new Map(map.snapshot());
+        while(!handoff.push(snapshot)) std::this_thread::yield();
+    }
+    reader.join();
+}
+
+static void stringSnapshotIsolation() {
+    ChimpMap<std::string> map;
+    std::map<std::string, std::string> expected;
+    for(int i = 0; i < 500; i++) {
+        map[wordFor(i)] = std::to_string(i);
+        expected[wordFor(i)] = std::to_string(i);
+    }
+
+    ChimpMap<std::string> snapshot = map.snapshot();
+    for(int i = 0; i < 500; i += 3) map.erase(wordFor(i));
+    for(int i = 1; i < 500; i += 3) map.emplace(wordFor(i), "changed");
+    ChimpMap<std::string> other;
+    other["zzz"] = "merged";
+    map.merge(std::move(other));
+    snapshot["ka"] = "written to the snapshot";
+
+    CHECK(map.count("zzz") && map[wordFor(1)] == "changed");
+    expected["ka"] = "written to the snapshot";
+    CHECK(snapshot.length() == expected.size());
+    auto want = expected.begin();
+    for(auto it = snapshot.begin(); it != snapshot.end(); ++it, ++want) {
+        CHECK(it->first == want->first && it->second == want->second);
+    }
+
+    map.clear();
+    CHECK(map.empty() && snapshot.length() == expected.size() && snapshot["kb"] == "1");
+}
+
+static void radixSnapshotIsolation() {
+    ChimpMap<int, uint64_t> map;
+    for(uint64_t i = 0; i < 1000; i++) map[i * 0x9E3779B97F4A7C15ull] = (int)i;
+
+    ChimpMap<int, uint64_t> snapshot = map.snapshot();
+    for(uint64_t i = 0; i < 1000; i += 2) map.erase(i * 0x9E3779B97F4A7C15ull);
+    map.emplace(7 * 0x9E3779B97F4A7C15ull, -7);
+    map[1] = 1;
+
+    CHECK(map.length() == 501 && map[7 * 0x9E3779B97F4A7C15ull] == -7);
+    CHECK(snapshot.length() == 1000 && !snapshot.count(1));
+    for(uint64_t i = 0; i < 1000; i++) CHECK(snapshot[i * 0x9E3779B97F4A7C15ull] == (int)i);
+}
+
+int main() {
+    snapshotsWhileWriting<ChimpMap<int>>(wordFor);
+    snapshotsWhileWriting<ChimpMap<int, uint64_t>>([](int i) { return uint64_t(i) * 0x9E3779B97F4A7C15ull; });
+    stringSnapshotIsolation();
+    radixSnapshotIsolation();
+    std::cout << "snapshots: ok" << std::endl;
+}